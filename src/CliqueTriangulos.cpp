@@ -7,6 +7,11 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include "FrameUniforms.h"
+#include "GlHandle.h"
+#include "GpuTrack.h"
+#include "HeapCount.h"
+#include "ProgramCache.h"
 #include <vector>
 #include <iostream>
 #include <cstdlib>
@@ -21,46 +26,65 @@ std::vector<glm::vec3> palette = {
 int nextColor = 0;
 
 struct Triangle {
-    GLuint VAO;
+    int first;              // primeiro vértice no buffer compartilhado
     glm::vec3 color;
 };
 std::vector<Triangle> triangles;
 
-std::vector<glm::vec2> pendingVerts;
-
-GLuint makeTriangleVAO(const glm::vec2 v0,
-                       const glm::vec2 v1,
-                       const glm::vec2 v2)
-{
-    float verts[] = {
-        v0.x, v0.y,
-        v1.x, v1.y,
-        v2.x, v2.y
-    };
-    GLuint VAO, VBO;
-    glGenVertexArrays(1,&VAO);
-    glGenBuffers     (1,&VBO);
-    glBindVertexArray(VAO);
-      glBindBuffer(GL_ARRAY_BUFFER,VBO);
-      glBufferData(GL_ARRAY_BUFFER,sizeof(verts),verts,GL_STATIC_DRAW);
-      glEnableVertexAttribArray(0);
-      glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,2*sizeof(float),(void*)0);
-    glBindVertexArray(0);
-    return VAO;
-}
+// nunca passa de 3: vetor fixo, sem heap a cada clique
+glm::vec2 pendingVerts[3];
+int       nPending = 0;
+bool      createdTriangle = false;     // o frame criou estado (FrameHeapCheck::allow)
+
+// todos os triângulos num VAO e num VBO só, com vértices acrescentados no
+// fim; cheio, o VBO dobra e o antigo vai para a fila de deleção (GlHandle.h)
+struct TriangleMesh {
+    GlVertexArray vao;
+    GlBuffer      vbo;
+    int capacity = 0, count = 0;        // em vértices
+
+    int append(const glm::vec2 v0,const glm::vec2 v1,const glm::vec2 v2){
+        if(count+3 > capacity) grow(capacity ? capacity*2 : 3*64);
+        glm::vec2 verts[3] = { v0, v1, v2 };
+        glBindBuffer(GL_ARRAY_BUFFER,vbo);
+        glBufferSubData(GL_ARRAY_BUFFER,count*sizeof(glm::vec2),sizeof(verts),verts);
+        glBindBuffer(GL_ARRAY_BUFFER,0);
+        int first = count;
+        count += 3;
+        return first;
+    }
+
+private:
+    void grow(int vertices){
+        if(!vao) vao = GlVertexArray::create();
+        GlBuffer next = GlBuffer::create();
+        glBindBuffer(GL_COPY_WRITE_BUFFER,next);
+        glBufferData(GL_COPY_WRITE_BUFFER,vertices*sizeof(glm::vec2),nullptr,GL_STATIC_DRAW);
+        if(count){
+            glBindBuffer(GL_COPY_READ_BUFFER,vbo);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER,GL_COPY_WRITE_BUFFER,0,0,count*sizeof(glm::vec2));
+        }
+        vbo = std::move(next);
+        capacity = vertices;
+        glBindVertexArray(vao);
+          glBindBuffer(GL_ARRAY_BUFFER,vbo);
+          glEnableVertexAttribArray(0);
+          glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,sizeof(glm::vec2),(void*)0);
+        glBindVertexArray(0);
+    }
+};
+TriangleMesh mesh;
 
 // ——————————————————————
 // Shaders mínimos
+// (versão e bloco Frame entram via frameStages)
 const char* vs_src = R"(
-#version 330 core
 layout(location=0) in vec2 aPos;
-uniform mat4 projection;
 void main(){
-    gl_Position = projection * vec4(aPos,0,1);
+    gl_Position = projection * view * vec4(aPos,0,1);
 }
 )";
 const char* fs_src = R"(
-#version 330 core
 out vec4 Frag;
 uniform vec3 uColor;
 void main(){
@@ -68,44 +92,37 @@ void main(){
 }
 )";
 
-GLuint compileShader(GLenum t,const char* src){
-    GLuint s=glCreateShader(t);
-    glShaderSource(s,1,&src,nullptr);
-    glCompileShader(s);
-    GLint ok; glGetShaderiv(s,GL_COMPILE_STATUS,&ok);
-    if(!ok){ char log[512]; glGetShaderInfoLog(s,512,nullptr,log);
-        std::cerr<<(t==GL_VERTEX_SHADER?"VS":"FS")<<" error:\n"<<log;
-    }
-    return s;
-}
-GLuint makeProgram(){
-    GLuint vs=compileShader(GL_VERTEX_SHADER,vs_src),
-           fs=compileShader(GL_FRAGMENT_SHADER,fs_src),
-           p=glCreateProgram();
-    glAttachShader(p,vs); glAttachShader(p,fs);
-    glLinkProgram(p);
-    glDeleteShader(vs); glDeleteShader(fs);
+// do cache de binários quando possível (ProgramCache.h)
+GlProgram makeProgram(){
+    GlProgram p = buildProgram(frameStages(vs_src,fs_src));
+    bindFrameBlock(p);
     return p;
 }
 
 // ——————————————————————
+// M: relatório de memória (heap por etiqueta e objetos GL)
+void key_cb(GLFWwindow* w,int key,int scancode,int action,int mods){
+    if(key==GLFW_KEY_M && action==GLFW_PRESS){ printHeapReport(); printGpuReport(); }
+}
+
 // Callback de clique
 void mouse_cb(GLFWwindow* w,int button,int action,int mods){
     if(button!=GLFW_MOUSE_BUTTON_LEFT||action!=GLFW_PRESS) return;
     double x,y; glfwGetCursorPos(w,&x,&y);
     // converte para coordenadas de mundo (origem no canto inferior esquerdo):
     y = SCR_H - y;
-    pendingVerts.emplace_back((float)x,(float)y);
-    if(pendingVerts.size()==3){
+    pendingVerts[nPending++] = glm::vec2((float)x,(float)y);
+    if(nPending==3){
         // cria triângulo
-        GLuint VAO = makeTriangleVAO(
+        int first = mesh.append(
             pendingVerts[0],
             pendingVerts[1],
             pendingVerts[2]
         );
-        triangles.push_back({ VAO, palette[nextColor] });
+        triangles.push_back({ first, palette[nextColor] });
         nextColor = (nextColor+1) % palette.size();
-        pendingVerts.clear();
+        nPending = 0;
+        createdTriangle = true;
     }
 }
 
@@ -119,32 +136,47 @@ int main(){
                                        "Clique→Vértice→Triângulo",nullptr,nullptr);
     glfwMakeContextCurrent(win);
     gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    installGpuTracking();
 
     // setup
-    GLuint program = makeProgram();
-    GLint locProj = glGetUniformLocation(program,"projection");
+    GlProgram program = makeProgram();
+    printProgramCacheStats();
     GLint locColor= glGetUniformLocation(program,"uColor");
-    glm::mat4 proj = glm::ortho(0.0f,(float)SCR_W,0.0f,(float)SCR_H,-1.0f,1.0f);
-    glUseProgram(program);
-    glUniformMatrix4fv(locProj,1,GL_FALSE,glm::value_ptr(proj));
+    FrameUniforms frame;
+    frame.init();
+    frame.data.projection = glm::ortho(0.0f,(float)SCR_W,0.0f,(float)SCR_H,-1.0f,1.0f);
+    frame.setViewport(0,0,SCR_W,SCR_H);
+    frame.upload(glfwGetTime(),0.0f);
 
     glfwSetMouseButtonCallback(win,mouse_cb);
+    glfwSetKeyCallback(win,key_cb);
 
-    // loop
+    // loop (em debug, só o frame que cria um triângulo pode alocar no heap)
+    FrameHeapCheck heapCheck;
     while(!glfwWindowShouldClose(win)){
         glfwPollEvents();
         glClearColor(0.1f,0.1f,0.1f,1);
         glClear(GL_COLOR_BUFFER_BIT);
 
         glUseProgram(program);
+        glBindVertexArray(mesh.vao);
         for(auto &tri : triangles){
             glUniform3fv(locColor,1,glm::value_ptr(tri.color));
-            glBindVertexArray(tri.VAO);
-            glDrawArrays(GL_TRIANGLES,0,3);
+            glDrawArrays(GL_TRIANGLES,tri.first,3);
         }
 
         glfwSwapBuffers(win);
+        glDeletionQueue().endFrame();
+        if(createdTriangle){ heapCheck.allow(); createdTriangle = false; }
+        heapCheck.endFrame();
     }
+    heapCheck.print();
+    mesh = TriangleMesh();
+    program.reset();
+    glDeletionQueue().flush();
+    glDeletionQueue().print();
+    printHeapReport();
+    printGpuReport();
 
     glfwTerminate();
     return 0;
@@ -0,0 +1,60 @@
+// CommandList.h
+// Gravação paralela e envio em série. Os sprites do frame são divididos em
+// pedaços, um por tarefa do JobSystem; cada pedaço tem um trecho só seu na
+// memória do StreamBuffer (reservado antes, com lugar para todos os seus
+// sprites), monta ali os registros e anota numa CommandList o que
+// desenhar: textura e intervalo de registros, sem nenhuma chamada GL.
+// Depois a thread do GL percorre as listas na ordem dos pedaços e traduz
+// cada comando num bind + draw (SpriteInstancer::submit). O culling só
+// encurta o que cada pedaço grava, então nenhum pedaço espera a contagem
+// dos outros; o preço são buracos no trecho.
+
+#pragma once
+
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// registros [first, first+count) do trecho reservado, com a textura
+struct SpriteCmd {
+    uint32_t texture;
+    int      first, count;
+};
+
+struct CommandList {
+    std::vector<SpriteCmd> cmds;
+    int sprites = 0;
+
+    void clear(){ cmds.clear(); sprites = 0; }
+
+    // emenda no comando anterior se a textura é a mesma e o registro é o seguinte
+    void draw(uint32_t texture,int index){
+        if(!cmds.empty() && cmds.back().texture==texture && cmds.back().first+cmds.back().count==index)
+            ++cmds.back().count;
+        else
+            cmds.push_back({texture,index,1});
+        ++sprites;
+    }
+};
+
+// grava count sprites em pedaços de grain, uma lista por pedaço, na ordem
+// dos índices. build(i,dst) devolve a textura do sprite i depois de
+// preencher dst, ou 0 sem escrever nada se o sprite foi descartado
+template<class Record,class Build>
+void recordParallel(JobSystem& js,Record* out,int count,int grain,
+                    std::vector<CommandList>& lists,const Build& build){
+    grain = std::max(1,grain);
+    int chunks = (count + grain - 1) / grain;
+    lists.resize(chunks);
+    js.parallelFor(0,chunks,1,[&](int c0,int c1){
+        for(int c=c0;c<c1;++c){
+            CommandList& l = lists[c];
+            l.clear();
+            int i0 = c*grain, i1 = std::min(count,i0+grain), k = i0;
+            for(int i=i0;i<i1;++i)
+                if(uint32_t tex = build(i,out[k])){ l.draw(tex,k); ++k; }
+        }
+    });
+}
@@ -9,152 +9,126 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// etiquetas do heap e objetos GL (tecla M imprime o relatório)
+#include "HeapCount.h"
+#include "GlHandle.h"
+#include "GpuTrack.h"
+
+// decodificação do stb também passa pela contabilidade do heap
+#define STBI_MALLOC(n)    heapAlloc(n)
+#define STBI_REALLOC(p,n) heapRealloc(p,n)
+#define STBI_FREE(p)      heapFree(p)
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
-
+#include "TextureLoader.h"
+#include "SpriteSheet.h"
+#include "RenderQueue.h"
+#include "YSortLayer.h"
+#include "DebugDraw.h"
+#include "ShaderVariants.h"
+#include "FrameUniforms.h"
+#include "FixedStep.h"
+#include "TripleBuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 // dimensão da janela
 const unsigned int SCR_W = 800, SCR_H = 600;
 
-GLuint loadTexture(const char* path){
+// camadas da fila de desenho e profundidade de cada uma
+// (maior = mais perto, com ortho near/far -1..1); dentro da camada do
+// mundo a profundidade sai da ordem por Y, entre WORLD_Z0 e WORLD_Z1
+const uint8_t LAYER_BG = 0, LAYER_WORLD = 1;
+const float   BG_Z = -0.9f, WORLD_Z0 = -0.5f, WORLD_Z1 = 0.5f;
+
+// simulação em passo fixo (FixedStep.h): passos por segundo e limite por frame
+const double SIM_HZ = 60.0;
+const int    SIM_MAX_STEPS = 5;
+
+// decodifica RGBA8 (linha 0 = base) e reduz para cobrir fitW x fitH (0 = sem limite)
+Image loadImage(const char* path,int fitW=0,int fitH=0){
     stbi_set_flip_vertically_on_load(true);
     int w,h,n;
-    unsigned char* data = stbi_load(path,&w,&h,&n,0);
-    if(!data){ std::cerr<<"Erro ao carregar "<<path<<"\n"; return 0; }
-    GLenum fmt = (n==3?GL_RGB:GL_RGBA);
-    GLuint t; glGenTextures(1,&t);
-    glBindTexture(GL_TEXTURE_2D,t);
-      glTexImage2D(GL_TEXTURE_2D,0,fmt,w,h,0,fmt,GL_UNSIGNED_BYTE,data);
-      glGenerateMipmap(GL_TEXTURE_2D);
-      glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
-      glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
-      glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR_MIPMAP_LINEAR);
-      glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+    unsigned char* data = stbi_load(path,&w,&h,&n,4);
+    if(!data){ std::cerr<<"Erro ao carregar "<<path<<"\n"; return Image(); }
+    Image img = Image::fromRGBA(w,h,data);
     stbi_image_free(data);
-    return t;
+    return fitToTarget(std::move(img),fitW,fitH);
 }
 
-// quad unitário com pos+uv
-GLuint quadVAO = 0;
-void initQuad(){
-    float V[] = {
-        // pos      // uv
-        -0.5f,  0.5f,   0.0f,1.0f,
-         0.5f, -0.5f,   1.0f,0.0f,
-        -0.5f, -0.5f,   0.0f,0.0f,
-        -0.5f,  0.5f,   0.0f,1.0f,
-         0.5f,  0.5f,   1.0f,1.0f,
-         0.5f, -0.5f,   1.0f,0.0f
-    };
-    GLuint VBO;
-    glGenVertexArrays(1,&quadVAO);
-    glGenBuffers(1,&VBO);
-    glBindVertexArray(quadVAO);
-      glBindBuffer(GL_ARRAY_BUFFER,VBO);
-      glBufferData(GL_ARRAY_BUFFER,sizeof(V),V,GL_STATIC_DRAW);
-      glEnableVertexAttribArray(0);
-      glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,4*sizeof(float),(void*)0);
-      glEnableVertexAttribArray(1);
-      glVertexAttribPointer(1,2,GL_FLOAT,GL_FALSE,4*sizeof(float),(void*)(2*sizeof(float)));
-    glBindVertexArray(0);
+// sobe a menor variante que cobre fitW x fitH
+// (usa o DDS comprimido do TextureBaker quando existe e o driver suporta)
+GlTexture loadTexture(const char* path,int fitW=0,int fitH=0){
+    if(GlTexture t = loadBakedTexture(path,fitW,fitH)) return t;
+    Image img = loadImage(path);
+    if(img.px.empty()) return GlTexture();
+    return uploadTextureFit(path,std::move(img),fitW,fitH);
 }
 
-// shaders com suporte a sub-UV + outline flag
-const char* vsSrc = R"glsl(
-#version 330 core
-layout(location=0) in vec2 aPos;
-layout(location=1) in vec2 aUV;
-uniform mat4 projection;
-uniform mat4 model;
-uniform vec2 texScale;
-uniform vec2 texOffset;
-out vec2 UV;
-void main(){
-    UV = aUV * texScale + texOffset;
-    gl_Position = projection * model * vec4(aPos,0,1);
-}
-)glsl";
-
-const char* fsSrc = R"glsl(
-#version 330 core
-in vec2 UV;
-out vec4 Frag;
-uniform sampler2D spriteTex;
-uniform bool   u_outline;
-uniform vec4   u_outlineColor;
-void main(){
-    if(u_outline)      Frag = u_outlineColor;
-    else               Frag = texture(spriteTex, UV);
-}
-)glsl";
-
-GLuint compileShader(GLenum t,const char*src){
-    GLuint s=glCreateShader(t);
-    glShaderSource(s,1,&src,nullptr);
-    glCompileShader(s);
-    GLint ok; char log[512];
-    glGetShaderiv(s,GL_COMPILE_STATUS,&ok);
-    if(!ok){
-        glGetShaderInfoLog(s,512,nullptr,log);
-        std::cerr<< (t==GL_VERTEX_SHADER?"VS":"FS") <<" error:\n"<<log;
-    }
-    return s;
-}
-GLuint createProgram(){
-    GLuint vs=compileShader(GL_VERTEX_SHADER,vsSrc);
-    GLuint fs=compileShader(GL_FRAGMENT_SHADER,fsSrc);
-    GLuint p=glCreateProgram();
-    glAttachShader(p,vs);
-    glAttachShader(p,fs);
-    glLinkProgram(p);
-    GLint ok; char log[512];
-    glGetProgramiv(p,GL_LINK_STATUS,&ok);
-    if(!ok){
-        glGetProgramInfoLog(p,512,nullptr,log);
-        std::cerr<<"Link error:\n"<<log;
-    }
-    glDeleteShader(vs);
-    glDeleteShader(fs);
-    return p;
+// spritesheet recortada/deduplicada, com células de cellW x cellH na tela
+SpriteSheet loadSpriteSheet(const char* path,int rows,int cols,int cellW,int cellH){
+    Image img = loadImage(path,cols*cellW,rows*cellH);
+    if(img.px.empty()) return SpriteSheet();
+    return uploadSpriteSheet(path,img,rows,cols);
 }
 
 struct Sprite {
-    GLuint   tex;
-    int      nRows,nCols;
+    const SpriteSheet* sheet;
     float    frameDur,acc=0;
     int      frame=0,anim=0;
 
-    Sprite(GLuint t,int rows,int cols,float dur)
-      : tex(t),nRows(rows),nCols(cols),frameDur(dur){}
+    Sprite(const SpriteSheet& s,float dur)
+      : sheet(&s),frameDur(dur){}
 
     void setAnimation(int row){
-        if(row<0||row>=nRows) return;
+        if(row<0||row>=sheet->nRows) return;
         if(anim!=row){ anim=row; frame=0; acc=0; }
     }
 
     void Update(float dt){
         acc+=dt;
-        if(acc>=frameDur){
-            frame=(frame+1)%nCols;
+        while(acc>=frameDur){
+            frame=(frame+1)%sheet->nCols;
             acc-=frameDur;
         }
     }
 
-    void Draw(GLuint prog){
-        // calcula sub-UV
-        glm::vec2 ds(1.0f/nCols,1.0f/nRows);
-        glm::vec2 off(frame*ds.x,(nRows-1-anim)*ds.y);
-        glUniform2fv(glGetUniformLocation(prog,"texScale"),1,glm::value_ptr(ds));
-        glUniform2fv(glGetUniformLocation(prog,"texOffset"),1,glm::value_ptr(off));
-        // draw
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D,tex);
-        glBindVertexArray(quadVAO);
-        glDrawArrays(GL_TRIANGLES,0,6);
+    // envia o casco do recorte do frame atual, deslocado dentro da célula
+    // pos/scale, na profundidade z; a fila decide passes e ordem
+    void Submit(RenderQueue& q,GLuint prog,uint8_t layer,glm::vec2 pos,glm::vec2 scale,float z) const {
+        submitSprite(q,prog,layer,*sheet,sheet->frame(anim,frame),pos,scale,z);
     }
 };
 
+// o que o render precisa de um ator: frame da animação e os dois últimos
+// estados simulados, para interpolar
+struct ActorSnap {
+    const SpriteSheet* sheet;
+    GLuint    prog;
+    int       anim, frame;
+    glm::vec2 prev, pos;
+};
+
+// cena publicada pela simulação depois de cada lote de passos; o render só lê
+struct SceneSnapshot {
+    std::vector<ActorSnap> actors;      // 0 = jogador, 1.. = NPCs
+    double simT = 0;                    // relógio em que o último passo vence
+    double inputT = 0;                  // leitura da última mudança de tecla
+    long   inputSeq = 0;
+    bool   debug = true;
+};
+
+// do render de volta para o título (a janela é da thread principal)
+struct RenderStats {
+    long   frames = 0, fullSorts = 0, latencyN = 0;
+    double seconds = 0, reorders = 0, latencyMs = 0, latencyMaxMs = 0;
+};
+
 int main(){
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR,3);
@@ -163,118 +137,251 @@ int main(){
     GLFWwindow* win = glfwCreateWindow(SCR_W,SCR_H,"Sprite Control",nullptr,nullptr);
     glfwMakeContextCurrent(win);
     gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    installGpuTracking();
 
     glViewport(0,0,SCR_W,SCR_H);
-    GLuint shader = createProgram();
-    glUseProgram(shader);
-
-    GLint locProj    = glGetUniformLocation(shader,"projection");
-    GLint locSprite  = glGetUniformLocation(shader,"spriteTex");
-    glUniformMatrix4fv(locProj,1,GL_FALSE,glm::value_ptr(
-      glm::ortho(0.0f,(float)SCR_W,0.0f,(float)SCR_H,-1.0f,1.0f)));
-    glUniform1i(locSprite,0);
-
-    GLint locModel        = glGetUniformLocation(shader,"model");
-    GLint locOutline      = glGetUniformLocation(shader,"u_outline");
-    GLint locOutlineColor = glGetUniformLocation(shader,"u_outlineColor");
-
-    initQuad();
-    GLuint outlineVAO, vboO;
-    {
-        float C[] = { -0.5f,0.5f,  0.5f,0.5f,  0.5f,-0.5f, -0.5f,-0.5f };
-        glGenVertexArrays(1,&outlineVAO);
-        glGenBuffers(1,&vboO);
-        glBindVertexArray(outlineVAO);
-          glBindBuffer(GL_ARRAY_BUFFER,vboO);
-          glBufferData(GL_ARRAY_BUFFER,sizeof(C),C,GL_STATIC_DRAW);
-          glEnableVertexAttribArray(0);
-          glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,2*sizeof(float),(void*)0);
-        glBindVertexArray(0);
-    }
-
-    Sprite bg   ( loadTexture("resources/background.png"),   1, 1, 1.0f );
-    Sprite idle ( loadTexture("resources/Gangsters/Idle.png"),   1, 7, 0.12f );
-    Sprite walk ( loadTexture("resources/Gangsters/Walk.png"),   1,10, 0.10f );
+    currentMemTag = MemTag::Shaders;
+    // todos os programas vão para o lote agora e compilam durante a carga:
+    // variantes do shader de sprite (o fundo é opaco e não precisa de
+    // discard; o mundo usa a faixa de alfa dos passes e os NPCs levam tinta)
+    // e os contornos de depuração (tecla O liga/desliga)
+    ProgramBatch programs(win);
+    ShaderVariants shaders;
+    shaders.request(programs,0);
+    shaders.request(programs,SH_ALPHA_TEST);
+    shaders.request(programs,SH_ALPHA_TEST | SH_TINT);
+    DebugDraw debug;
+    debug.init(&programs);
+    bool oWasDown = false, mWasDown = false;
+
+    currentMemTag = MemTag::Sprites;
 
     glm::vec2 bgPos   = { SCR_W * 0.5f, SCR_H * 0.5f };
     glm::vec2 bgScale = { (float)SCR_W,  (float)SCR_H   };
     glm::vec2 playerPos   = { 400.0f, 300.0f };
     glm::vec2 playerScale = {  64.0f,  64.0f   };
+
+    // cada textura sobe no tamanho em que aparece na tela (fundo = janela,
+    // spritesheet = N colunas de frames de playerScale)
+    SpriteSheet bgSheet   = SpriteSheet::whole(loadTexture("resources/background.png", SCR_W, SCR_H));
+    SpriteSheet idleSheet = loadSpriteSheet("resources/Gangsters/Idle.png", 1, 7, (int)playerScale.x, (int)playerScale.y);
+    SpriteSheet walkSheet = loadSpriteSheet("resources/Gangsters/Walk.png", 1,10, (int)playerScale.x, (int)playerScale.y);
+    Sprite bg   ( bgSheet,   1.0f );
+    Sprite idle ( idleSheet, 0.12f );
+    Sprite walk ( walkSheet, 0.10f );
+    printTextureStats();
+    currentMemTag = MemTag::Render;
+
+    programs.finish();
+    programs.print();
+    printProgramCacheStats();
+    GLuint bgShader     = shaders.get<0>();
+    GLuint spriteShader = shaders.get<SH_ALPHA_TEST>();
+    GLuint npcShader    = shaders.get<SH_ALPHA_TEST | SH_TINT>();
+    shaders.setCommon();
+
+    // projeção, câmera, tempo e viewport: um UBO para todos os programas
+    FrameUniforms frame;
+    frame.init();
+    frame.data.projection = glm::ortho(0.0f,(float)SCR_W,0.0f,(float)SCR_H,-1.0f,1.0f);
+    frame.setViewport(0,0,SCR_W,SCR_H);
+    glUseProgram(npcShader);
+    glUniform4f(glGetUniformLocation(npcShader,"u_tint"),0.75f,0.8f,1.0f,1.0f);
     Sprite*   player      = &idle;
 
+    // gângsteres parados espalhados pelo cenário, para o jogador passar
+    // por trás e pela frente deles
+    struct Npc { glm::vec2 pos; Sprite sprite; };
+    std::vector<Npc> npcs;
+    const glm::vec2 npcPos[] = { {180,420}, {560,380}, {320,240}, {650,170}, {240,110} };
+    for(int i=0;i<5;++i){
+        npcs.push_back({ npcPos[i], Sprite(idleSheet,0.12f) });
+        npcs.back().sprite.frame = (i*3) % idleSheet.nCols;       // fora de fase
+    }
+
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
 
-    float lastT = (float)glfwGetTime();
     const float speed = 200.0f;
+    const size_t nActors = 1 + npcs.size();
+
+    // simulação (esta thread, dona da janela e da entrada) -> render
+    TripleBuffer<SceneSnapshot> scenes;
+    TripleBuffer<RenderStats>   renderStats;
+    std::atomic<bool> running{true};
+
+    FixedStep sim(SIM_HZ,SIM_MAX_STEPS);
+    glm::vec2 prevPlayerPos = playerPos;
+    bool   showDebug = debug.enabled;
+    int    keys = 0;
+    long   inputSeq = 0;
+    double inputT = 0;
+
+    auto publishScene = [&](double simT){
+        SceneSnapshot& s = scenes.back();
+        s.actors.clear();
+        s.actors.push_back({ player->sheet, spriteShader, player->anim, player->frame, prevPlayerPos, playerPos });
+        for(const Npc& n : npcs)
+            s.actors.push_back({ n.sprite.sheet, npcShader, n.sprite.anim, n.sprite.frame, n.pos, n.pos });
+        s.simT     = simT;
+        s.inputT   = inputT;
+        s.inputSeq = inputSeq;
+        s.debug    = showDebug;
+        scenes.publish();
+    };
+    publishScene(glfwGetTime());
+
+    // o contexto passa para a thread de render; daqui em diante esta
+    // thread não chama GL
+    glfwMakeContextCurrent(nullptr);
+    std::thread renderThread([&]{
+        MemTagScope tag(MemTag::Render);
+        glfwMakeContextCurrent(win);
+        glfwSwapInterval(1);
+
+        // atores do mundo ordenados por Y: 0 = jogador, 1.. = NPCs
+        RenderQueue queue;
+        YSortLayer  world;
+        std::vector<float>     worldY(nActors);
+        std::vector<glm::vec2> drawPos(nActors);
+        for(size_t i=0;i<nActors;++i) world.add((int)i);
+
+        long   frames = 0, reorders = 0, fullSorts = 0, shownSeq = 0, latN = 0;
+        double latSum = 0, latMax = 0;
+        double lastT = glfwGetTime(), statT = lastT;
+        while(running.load(std::memory_order_acquire)){
+            double now = glfwGetTime();
+            float  dt  = (float)(now - lastT); lastT = now;
+
+            scenes.fetch();
+            const SceneSnapshot& s = scenes.front();
+            if(s.debug != debug.enabled) debug.toggle();
+
+            // entre os dois últimos passos, pelo relógio do render
+            float a = (float)std::clamp((now - s.simT)/sim.step,0.0,1.0);
+            for(size_t i=0;i<nActors;++i){
+                drawPos[i] = glm::mix(s.actors[i].prev,s.actors[i].pos,a);
+                worldY[i]  = drawPos[i].y - playerScale.y*0.5f;      // ordem do pintor pelos pés
+            }
+            world.update(worldY.data());
+            reorders += world.stats.reordered; fullSorts += world.stats.fullSort;
+
+            frame.upload(now,dt);
+
+            glClearColor(0,0,0,1);
+            glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
+
+            // a ordem de envio não importa: a fila ordena por passe/camada/estado/profundidade
+            queue.clear();
+            bg.Submit(queue,bgShader,LAYER_BG,bgPos,bgScale,BG_Z);
+            for(size_t r=0;r<world.order.size();++r){
+                int   i = world.order[r];
+                float z = WORLD_Z0 + (WORLD_Z1-WORLD_Z0) * (r+1) / (world.order.size()+1);
+                const ActorSnap& act = s.actors[i];
+                submitSprite(queue,act.prog,LAYER_WORLD,*act.sheet,act.sheet->frame(act.anim,act.frame),
+                             drawPos[i],playerScale,z);
+            }
+            queue.sort();
+            glActiveTexture(GL_TEXTURE0);
+            queue.execute();
+
+            // contornos das células: tudo acumulado e enviado num draw
+            const glm::vec4 white(1,1,1,1);
+            debug.rect(bgPos,bgScale,white);
+            for(const glm::vec2& p : drawPos) debug.rect(p,playerScale,white);
+            debug.flush();
+
+            glfwSwapBuffers(win);
+            glDeletionQueue().endFrame();
+            ++frames;
+
+            // latência: da leitura da tecla até a volta do swap do primeiro
+            // frame com um passo que a usou (com vsync, o frame já está na
+            // fila da apresentação; falta no máximo a varredura)
+            if(s.inputSeq != shownSeq){
+                double l = (glfwGetTime() - s.inputT)*1000.0;
+                latSum += l; latMax = std::max(latMax,l); ++latN;
+                shownSeq = s.inputSeq;
+            }
+            if(now - statT >= 0.5){
+                RenderStats& st = renderStats.back();
+                st.frames       = frames;
+                st.seconds      = now - statT;
+                st.reorders     = (double)reorders/frames;
+                st.fullSorts    = fullSorts;
+                st.latencyMs    = latN ? latSum/latN : 0.0;
+                st.latencyMaxMs = latMax;
+                st.latencyN     = latN;
+                renderStats.publish();
+                frames = reorders = fullSorts = latN = 0; latSum = latMax = 0; statT = now;
+            }
+        }
+        glfwMakeContextCurrent(nullptr);
+    });
 
+    // simulação: passos fixos, acordando no próximo passo ou antes, se
+    // chegar evento (a tecla é carimbada na hora em que é lida)
+    long   titleSteps = 0;
+    double wait = 0;
     while(!glfwWindowShouldClose(win)){
-        float now = (float)glfwGetTime();
-        float dt  = now - lastT; lastT = now;
-
-        glfwPollEvents();
+        if(wait > 0) glfwWaitEventsTimeout(wait);
+        else         glfwPollEvents();
+        double now = glfwGetTime();
         if(glfwGetKey(win,GLFW_KEY_ESCAPE)==GLFW_PRESS) break;
+        bool oDown = glfwGetKey(win,GLFW_KEY_O)==GLFW_PRESS;
+        if(oDown && !oWasDown) showDebug = !showDebug;      // o render aplica o toggle
+        oWasDown = oDown;
+        bool mDown = glfwGetKey(win,GLFW_KEY_M)==GLFW_PRESS;
+        if(mDown && !mWasDown){ printHeapReport(); printGpuReport(); }
+        mWasDown = mDown;
 
         bool up    = glfwGetKey(win,GLFW_KEY_W)==GLFW_PRESS;
         bool down  = glfwGetKey(win,GLFW_KEY_S)==GLFW_PRESS;
         bool left  = glfwGetKey(win,GLFW_KEY_A)==GLFW_PRESS;
         bool right = glfwGetKey(win,GLFW_KEY_D)==GLFW_PRESS;
-
-        if(up||down||left||right){
-            player = &walk;
-            if(up)    playerPos.y += speed * dt;
-            if(down)  playerPos.y -= speed * dt;
-            if(left)  playerPos.x -= speed * dt;
-            if(right) playerPos.x += speed * dt;
-        } else {
-            player = &idle;
+        int mask = up | down<<1 | left<<2 | right<<3;
+        if(mask != keys){ keys = mask; inputT = now; ++inputSeq; }
+
+        int steps = sim.advance(now);
+        for(int k=0;k<steps;++k){
+            const float h = (float)sim.step;
+            prevPlayerPos = playerPos;
+            if(up||down||left||right){
+                player = &walk;
+                if(up)    playerPos.y += speed * h;
+                if(down)  playerPos.y -= speed * h;
+                if(left)  playerPos.x -= speed * h;
+                if(right) playerPos.x += speed * h;
+            } else {
+                player = &idle;
+            }
+            player->Update(h);
+            for(Npc& n : npcs) n.sprite.Update(h);
         }
-        player->Update(dt);
-
-        glClearColor(0,0,0,1);
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        glPolygonMode(GL_FRONT_AND_BACK,GL_FILL);
-        glUniform1i(locOutline,0);
-
-        {
-          glm::mat4 M = glm::translate(glm::mat4(1.0f), glm::vec3(bgPos,0.0f))
-                      * glm::scale   (glm::mat4(1.0f), glm::vec3(bgScale,1.0f));
-          glUniformMatrix4fv(locModel,1,GL_FALSE,glm::value_ptr(M));
-          bg.Draw(shader);
-        }
-        {
-          glm::mat4 M = glm::translate(glm::mat4(1.0f), glm::vec3(playerPos,0.0f))
-                      * glm::scale   (glm::mat4(1.0f), glm::vec3(playerScale,1.0f));
-          glUniformMatrix4fv(locModel,1,GL_FALSE,glm::value_ptr(M));
-          player->Draw(shader);
-        }
-
-        glPolygonMode(GL_FRONT_AND_BACK,GL_LINE);
-        glUniform1i(locOutline,1);
-        glUniform4f(locOutlineColor,1,1,1,1);
-        glLineWidth(2.0f);
-        glBindVertexArray(outlineVAO);
-
-        {
-          glm::mat4 M = glm::translate(glm::mat4(1.0f), glm::vec3(bgPos,0.0f))
-                      * glm::scale   (glm::mat4(1.0f), glm::vec3(bgScale,1.0f));
-          glUniformMatrix4fv(locModel,1,GL_FALSE,glm::value_ptr(M));
-          glDrawArrays(GL_LINE_LOOP,0,4);
+        titleSteps += steps;
+        if(steps) publishScene(now - sim.acc);
+
+        if(renderStats.fetch()){
+            const RenderStats& st = renderStats.front();
+            char title[256];
+            std::snprintf(title,sizeof title,"Sprite Control — %.0f fps, entrada→tela: %.1f ms (máx %.1f, %ld), "
+                          "reordenações/frame: %.2f, ordenações completas: %ld, passos/frame: %.2f, cenas descartadas: %ld",
+                          st.frames/st.seconds, st.latencyMs, st.latencyMaxMs, st.latencyN,
+                          st.reorders, st.fullSorts, (double)titleSteps/st.frames, scenes.dropped);
+            glfwSetWindowTitle(win,title);
+            titleSteps = 0;
         }
-        {
-          glm::mat4 M = glm::translate(glm::mat4(1.0f), glm::vec3(playerPos,0.0f))
-                      * glm::scale   (glm::mat4(1.0f), glm::vec3(playerScale,1.0f));
-          glUniformMatrix4fv(locModel,1,GL_FALSE,glm::value_ptr(M));
-          glDrawArrays(GL_LINE_LOOP,0,4);
-        }
-
-        glPolygonMode(GL_FRONT_AND_BACK,GL_FILL);
-        glUniform1i(locOutline,0);
-
-        glfwSwapBuffers(win);
+        wait = sim.step - sim.acc - (glfwGetTime() - now);
     }
 
+    running.store(false,std::memory_order_release);
+    renderThread.join();
+    // a thread de render soltou o contexto: volta para apagar o que sobrou
+    glfwMakeContextCurrent(win);
+    glDeletionQueue().flush();
+    glDeletionQueue().print();
+    printHeapReport();
+    printGpuReport();
     glfwTerminate();
     return 0;
 }
@@ -0,0 +1,130 @@
+// DebugDraw.h
+// Linhas e contornos de depuração acumulados num único buffer e enviados
+// num só draw por frame. Cada segmento vira um quad (2 triângulos) já na
+// CPU, com a espessura em pixels: o core profile não garante glLineWidth
+// acima de 1. Os vértices guardam posição e cor (RGBA8), então contornos
+// de cores diferentes também saem juntos, e sobem pelo StreamBuffer sem
+// esperar o draw do frame anterior. Desligado, cada chamada retorna na
+// primeira linha e flush() não toca no GL.
+
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "FrameUniforms.h"
+#include "ProgramBatch.h"
+#include "ProgramCache.h"
+#include "StreamBuffer.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+struct DebugVertex {
+    float    x, y;
+    uint32_t rgba;      // R no byte baixo
+};
+
+inline uint32_t packColor(glm::vec4 c){
+    auto b = [](float v){ return (uint32_t)(std::fmin(std::fmax(v,0.0f),1.0f)*255.0f + 0.5f); };
+    return b(c.x) | b(c.y)<<8 | b(c.z)<<16 | b(c.w)<<24;
+}
+
+struct DebugDraw {
+    bool                     enabled = true;
+    std::vector<DebugVertex> verts;
+    StreamBuffer stream;
+    GlVertexArray vao;
+    GlProgram     program;
+    bool    bound = false;      // bloco Frame ligado no primeiro flush (o link pode estar em andamento)
+    int     layoutGen = -1;     // geração do stream ligada no VAO
+    int     lastSegments = 0;   // segmentos enviados no último flush
+
+    // com batch, o programa entra no lote de compilação da demo
+    void init(ProgramBatch* batch = nullptr){
+        const char* vs = R"glsl(
+layout(location=0) in vec2 aPos;
+layout(location=1) in vec4 aColor;
+out vec4 Color;
+void main(){
+    Color = aColor;
+    gl_Position = projection * view * vec4(aPos,0,1);
+}
+)glsl";
+        const char* fs = R"glsl(
+in vec4 Color;
+out vec4 Frag;
+void main(){ Frag = Color; }
+)glsl";
+        program = batch ? batch->submit(frameStages(vs,fs)) : buildProgram(frameStages(vs,fs));
+
+        vao = GlVertexArray::create();
+        stream.init(256*1024);
+    }
+
+    void toggle(){ enabled = !enabled; verts.clear(); }
+
+    // segmento a-b com espessura w (px); ext estende as pontas em w/2,
+    // para os cantos de um retângulo fecharem sem falha
+    void line(glm::vec2 a,glm::vec2 b,glm::vec4 color,float w=2.0f,bool ext=false){
+        if(!enabled) return;
+        glm::vec2 d = b - a;
+        float len = std::sqrt(d.x*d.x + d.y*d.y);
+        if(len < 1e-6f) return;
+        d = d * (1.0f/len);
+        glm::vec2 n = glm::vec2(-d.y,d.x) * (w*0.5f);
+        if(ext){ a -= d*(w*0.5f); b += d*(w*0.5f); }
+        uint32_t c = packColor(color);
+        glm::vec2 p0 = a - n, p1 = b - n, p2 = b + n, p3 = a + n;
+        verts.push_back({p0.x,p0.y,c}); verts.push_back({p1.x,p1.y,c}); verts.push_back({p2.x,p2.y,c});
+        verts.push_back({p0.x,p0.y,c}); verts.push_back({p2.x,p2.y,c}); verts.push_back({p3.x,p3.y,c});
+    }
+
+    // contorno do retângulo de centro c e tamanho s, por dentro da borda
+    void rect(glm::vec2 c,glm::vec2 s,glm::vec4 color,float w=2.0f){
+        if(!enabled) return;
+        glm::vec2 h = s*0.5f - glm::vec2(w*0.5f);
+        glm::vec2 lo = c - h, hi = c + h;
+        line({lo.x,lo.y},{hi.x,lo.y},color,w,true);
+        line({lo.x,hi.y},{hi.x,hi.y},color,w,true);
+        line({lo.x,lo.y},{lo.x,hi.y},color,w);
+        line({hi.x,lo.y},{hi.x,hi.y},color,w);
+    }
+
+    // polígono fechado (ex.: casco de um frame já em coordenadas de tela)
+    void polygon(const std::vector<glm::vec2>& p,glm::vec4 color,float w=2.0f){
+        if(!enabled) return;
+        for(size_t i=0;i<p.size();++i) line(p[i],p[(i+1)%p.size()],color,w,true);
+    }
+
+    // envia tudo num draw e esvazia o acumulador (projeção/câmera vêm do
+    // bloco Frame); uma vez por frame, depois de todas as linhas
+    void flush(){
+        lastSegments = (int)(verts.size()/6);
+        if(!enabled || verts.empty()){ verts.clear(); return; }
+        size_t at = stream.write(verts.data(),verts.size()*sizeof(DebugVertex),sizeof(DebugVertex));
+        if(layoutGen != stream.generation) bindLayout();
+
+        if(!bound){ bindFrameBlock(program); bound = true; }
+        glUseProgram(program);
+        glBindVertexArray(vao);
+        glDrawArrays(GL_TRIANGLES,(GLint)(at/sizeof(DebugVertex)),(GLsizei)verts.size());
+        glBindVertexArray(0);
+        stream.endFrame();
+        verts.clear();
+    }
+
+private:
+    // atributos apontam para o início do stream; cada draw escolhe o first
+    void bindLayout(){
+        glBindVertexArray(vao);
+          glBindBuffer(GL_ARRAY_BUFFER,stream.buffer);
+          glEnableVertexAttribArray(0);
+          glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,sizeof(DebugVertex),(void*)0);
+          glEnableVertexAttribArray(1);
+          glVertexAttribPointer(1,4,GL_UNSIGNED_BYTE,GL_TRUE,sizeof(DebugVertex),(void*)(2*sizeof(float)));
+        glBindVertexArray(0);
+        layoutGen = stream.generation;
+    }
+};
@@ -0,0 +1,43 @@
+// FixedStep.h
+// Simulação em passo fixo, desacoplada da taxa de render. Cada frame
+// acumula o tempo real (double, glfwGetTime) e consome passos inteiros de
+// 1/hz; o resto fica para o próximo frame, e alpha() diz quanto do passo
+// seguinte já passou, para o render interpolar entre os dois últimos
+// estados. Um frame muito longo (janela arrastada, breakpoint) dá no
+// máximo maxSteps passos e o excesso é descartado, em vez de a simulação
+// tentar recuperar e atrasar cada vez mais.
+
+#pragma once
+
+struct FixedStep {
+    double step;                // s por passo
+    int    maxSteps;
+    double acc  = 0;            // tempo real ainda não simulado
+    double time = 0;            // tempo simulado desde o início
+    double last = -1;
+    long   steps = 0;
+    double dropped = 0;         // s descartados pelo limite de passos
+
+    explicit FixedStep(double hz = 60.0,int maxStepsPerFrame = 5)
+      : step(1.0/hz), maxSteps(maxStepsPerFrame) {}
+
+    // passos a simular neste frame
+    int advance(double now){
+        if(last < 0) last = now;
+        acc += now - last;
+        last = now;
+        int n = (int)(acc/step);
+        if(n > maxSteps){
+            dropped += (n-maxSteps)*step;
+            acc -= (n-maxSteps)*step;
+            n = maxSteps;
+        }
+        acc  -= n*step;
+        time += n*step;
+        steps += n;
+        return n;
+    }
+
+    // fração do próximo passo já decorrida, em [0,1)
+    float alpha() const { return (float)(acc/step); }
+};
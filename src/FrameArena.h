@@ -0,0 +1,124 @@
+// FrameArena.h
+// Memória de rascunho por frame: alocar é avançar um ponteiro e nada é
+// liberado individualmente. São dois buffers em rodízio; endFrame() troca
+// de buffer e zera o que volta a ser o atual, então o que foi alocado no
+// frame N continua válido durante o frame N+1 (para quem consome com um
+// frame de atraso) e some no fim dele. O que não cabe vai para blocos
+// extras do heap (overflows), e no reset o buffer é realocado com o pico
+// visto: passado o aquecimento, nenhum frame toca mais no heap.
+// Não é thread-safe; um arena por thread.
+// ArenaAllocator<T> liga o arena aos containers da STL (FrameVector<T>).
+// deallocate não faz nada: um vector que cresce deixa o bloco antigo para
+// trás até o reset, então vale reservar o tamanho de uma vez.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+struct ArenaStats {
+    size_t capacity = 0;            // bytes do buffer atual
+    size_t used = 0, peak = 0;      // no frame atual / no maior frame
+    long   allocs = 0, frames = 0;
+    long   overflows = 0;           // blocos extras que vieram do heap
+    long   heapAllocs = 0;          // tudo que o arena pediu ao heap (inclui os buffers)
+};
+
+struct FrameArena {
+    ArenaStats stats;
+
+    explicit FrameArena(size_t bytes = 64*1024){
+        for(Buffer& b : buffers) resize(b,bytes);
+        stats.capacity = bytes;
+    }
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* alloc(size_t n,size_t align = alignof(std::max_align_t)){
+        Buffer& b = buffers[current];
+        ++stats.allocs;
+        size_t at = alignUp(b.used,align);
+        if(at+n <= b.size){
+            b.used = at+n;
+            stats.used = b.used + b.extraBytes;
+            return b.mem.get() + at;
+        }
+        // não coube: bloco próprio até o reset
+        b.extra.emplace_back(new unsigned char[n+align]);
+        b.extraBytes += n+align;
+        stats.used = b.used + b.extraBytes;
+        ++stats.overflows;
+        ++stats.heapAllocs;
+        unsigned char* p = b.extra.back().get();
+        return p + (alignUp((size_t)p,align) - (size_t)p);
+    }
+
+    template<class T>
+    T* alloc(size_t count){ return (T*)alloc(count*sizeof(T),alignof(T)); }
+
+    // no fim do frame: o buffer do frame anterior volta vazio
+    void endFrame(){
+        stats.peak = std::max(stats.peak,stats.used);
+        ++stats.frames;
+        current ^= 1;
+        Buffer& b = buffers[current];
+        if(b.size < stats.peak) resize(b,stats.peak + stats.peak/4);
+        b.extra.clear();
+        b.extraBytes = 0;
+        b.used = 0;
+        stats.used = 0;
+        stats.capacity = b.size;
+    }
+
+    void print(const char* name) const {
+        std::printf("[arena] %-10s %zu KB por buffer, pico %.1f KB/frame, %.1f alocações/frame, "
+                    "%ld estouros, %ld pedidos ao heap\n",
+                    name, stats.capacity/1024, stats.peak/1024.0,
+                    (double)stats.allocs/std::max(1L,stats.frames), stats.overflows, stats.heapAllocs);
+    }
+
+private:
+    struct Buffer {
+        std::unique_ptr<unsigned char[]> mem;
+        size_t size = 0, used = 0;
+        std::vector<std::unique_ptr<unsigned char[]>> extra;
+        size_t extraBytes = 0;
+    };
+    Buffer buffers[2];
+    int    current = 0;
+
+    static size_t alignUp(size_t v,size_t a){ return (v + a-1)/a*a; }
+
+    void resize(Buffer& b,size_t bytes){
+        b.mem.reset(new unsigned char[bytes]);
+        b.size = bytes;
+        ++stats.heapAllocs;
+    }
+};
+
+// arena da thread principal, zerado pelo loop de cada demo
+inline FrameArena& frameArena(){
+    static FrameArena a;
+    return a;
+}
+
+template<class T>
+struct ArenaAllocator {
+    using value_type = T;
+    FrameArena* arena;
+
+    ArenaAllocator(FrameArena& a = frameArena()) : arena(&a) {}
+    template<class U> ArenaAllocator(const ArenaAllocator<U>& o) : arena(o.arena) {}
+
+    T*   allocate(size_t n){ return arena->alloc<T>(n); }
+    void deallocate(T*,size_t){}
+
+    template<class U> bool operator==(const ArenaAllocator<U>& o) const { return arena==o.arena; }
+    template<class U> bool operator!=(const ArenaAllocator<U>& o) const { return arena!=o.arena; }
+};
+
+template<class T>
+using FrameVector = std::vector<T,ArenaAllocator<T>>;
@@ -0,0 +1,68 @@
+// FrameArenaTest.cpp
+// Teste só de CPU (sem janela/GL) do regime sem heap: simula os frames de
+// uma demo, com listas em FrameVector e rascunho direto do arena em
+// quantidades que variam de frame a frame, e falha se algum frame depois
+// do aquecimento chamar o operator new. Roda a cada build (check_frame_heap),
+// em release também: a contagem não depende do assert.
+//
+// uso: FrameArenaTest [frames]
+
+#include "HeapCount.h"
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+
+const int GRID  = 64*64;        // células de um tabuleiro grande
+const int WORST = 3;            // frames iniciais no pior caso: o arena cresce até o pico
+
+// o trabalho de um frame: n células removidas, ordenadas por distância, e
+// um rascunho de vértices; devolve algo para o otimizador não apagar tudo
+static float frameWork(int n,std::mt19937& rng){
+    FrameVector<std::pair<int,float>> removed;
+    removed.reserve(GRID);
+    for(int i=0;i<n;++i) removed.push_back({ (int)(rng()%GRID), (float)(rng()%1000) });
+    std::sort(removed.begin(),removed.end(),
+              [](const std::pair<int,float>& a,const std::pair<int,float>& b){ return a.second<b.second; });
+
+    float* verts = frameArena().alloc<float>(n*12 + 1);
+    float sum = 0;
+    for(int i=0;i<n*12;++i){ verts[i] = removed[i/12].second*0.5f; sum += verts[i]; }
+    return sum;
+}
+
+int main(int argc,char** argv){
+    int frames = argc>=2 ? std::atoi(argv[1]) : 1000;
+    int fails = 0;
+
+    // o contador enxerga uma alocação (chamada explícita: o compilador não
+    // pode eliminar o par new/delete)
+    long before = heapNews.load();
+    void* probe = ::operator new(16);
+    bool counted = heapNews.load()==before+1;
+    ::operator delete(probe);
+    std::printf("[selftest] operator new contado          %s\n", counted ? "ok" : "FALHOU");
+    fails += !counted;
+
+    std::mt19937 rng(12345);
+    FrameHeapCheck check;
+    check.warmup = WORST;
+    float sink = 0;
+    for(int f=0; f<frames; ++f){
+        int n = f<WORST ? GRID : (int)(rng()%GRID);
+        sink += frameWork(n,rng);
+        frameArena().endFrame();
+        check.endFrame();
+    }
+    bool steady = check.violations==0 && check.steady==frames-WORST;
+    std::printf("[selftest] %d frames em regime sem heap   %s (%ld com alocação)\n",
+                frames-WORST, steady ? "ok" : "FALHOU", check.violations);
+    fails += !steady;
+    frameArena().print("teste");
+    check.print();
+
+    return fails || sink<0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
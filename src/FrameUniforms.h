@@ -0,0 +1,75 @@
+// FrameUniforms.h
+// Dados por frame num uniform buffer std140 compartilhado por todos os
+// programas de sprite e de forma: projeção, view (câmera), tempo e viewport.
+// O buffer fica preso no ponto de ligação FRAME_UBO_BINDING e cada programa
+// aponta o bloco "Frame" para lá uma vez, depois do link; mudar a câmera
+// ou redimensionar a janela custa um glBufferSubData por frame, sem
+// glUseProgram/glUniform em cada programa.
+
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "GlHandle.h"
+#include "ProgramCache.h"
+
+#include <cstddef>
+#include <vector>
+
+const GLuint FRAME_UBO_BINDING = 0;
+
+const char* const GLSL_VERSION = "#version 330 core\n";
+
+// bloco GLSL correspondente a FrameData (std140: mat4 = 4 vec4, sem padding extra)
+const char* const FRAME_BLOCK_GLSL = R"glsl(
+layout(std140) uniform Frame {
+    mat4 projection;
+    mat4 view;
+    vec4 u_time;        // x = segundos desde o início, y = dt
+    vec4 u_viewport;    // x, y, largura, altura (px)
+};
+)glsl";
+
+struct FrameData {
+    glm::mat4 projection{1.0f};
+    glm::mat4 view{1.0f};
+    glm::vec4 time{0.0f};
+    glm::vec4 viewport{0.0f};
+};
+static_assert(sizeof(FrameData) == 160, "FrameData precisa bater com o layout std140 do bloco Frame");
+
+// vertex shader com o bloco Frame logo depois da versão (+ fragment shader)
+inline std::vector<ShaderStage> frameStages(const char* vsBody,const char* fsBody){
+    return { {GL_VERTEX_SHADER,  {GLSL_VERSION,FRAME_BLOCK_GLSL,vsBody}},
+             {GL_FRAGMENT_SHADER,{GLSL_VERSION,fsBody}} };
+}
+
+// aponta o bloco Frame do programa para o ponto de ligação comum
+inline void bindFrameBlock(GLuint program){
+    GLuint idx = glGetUniformBlockIndex(program,"Frame");
+    if(idx != GL_INVALID_INDEX) glUniformBlockBinding(program,idx,FRAME_UBO_BINDING);
+}
+
+struct FrameUniforms {
+    GlBuffer  ubo;
+    FrameData data;
+
+    void init(){
+        ubo = GlBuffer::create();
+        glBindBuffer(GL_UNIFORM_BUFFER,ubo);
+        glBufferData(GL_UNIFORM_BUFFER,sizeof(FrameData),nullptr,GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER,0);
+        glBindBufferBase(GL_UNIFORM_BUFFER,FRAME_UBO_BINDING,ubo);
+    }
+
+    // um upload por frame com tudo que mudou
+    void upload(double seconds,float dt){
+        data.time = glm::vec4((float)seconds,dt,0.0f,0.0f);
+        glBindBuffer(GL_UNIFORM_BUFFER,ubo);
+        glBufferSubData(GL_UNIFORM_BUFFER,0,sizeof(FrameData),&data);
+        glBindBuffer(GL_UNIFORM_BUFFER,0);
+    }
+
+    void setViewport(int x,int y,int w,int h){ data.viewport = glm::vec4((float)x,(float)y,(float)w,(float)h); }
+};
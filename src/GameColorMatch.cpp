@@ -10,6 +10,12 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "FrameArena.h"
+#include "FrameUniforms.h"
+#include "GlHandle.h"
+#include "HeapCount.h"
+#include "ProgramCache.h"
+
 #include <vector>
 #include <random>
 #include <iostream>
@@ -60,19 +66,16 @@ float colorDistance(const glm::vec3& a, const glm::vec3& b) {
     return glm::length(a - b);
 }
 
-// Shaders GLSL 330 core
+// Shaders GLSL 330 core (versão e bloco Frame entram via frameStages)
 const char* vertexShaderSource = R"(
-#version 330 core
 layout (location = 0) in vec3 position;
-uniform mat4 projection;
 uniform mat4 model;
 void main() {
-    gl_Position = projection * model * vec4(position, 1.0);
+    gl_Position = projection * view * model * vec4(position, 1.0);
 }
 )";
 
 const char* fragmentShaderSource = R"(
-#version 330 core
 out vec4 fragColor;
 uniform vec4 inputColor;
 void main() {
@@ -80,49 +83,19 @@ void main() {
 }
 )";
 
-// Compila e linka shaders, retorna o programa
-GLuint setupShaderProgram() {
-    GLint success;
-    GLchar infoLog[512];
-
-    // Vertex Shader
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader,1,&vertexShaderSource,nullptr);
-    glCompileShader(vertexShader);
-    glGetShaderiv(vertexShader,GL_COMPILE_STATUS,&success);
-    if(!success) {
-        glGetShaderInfoLog(vertexShader,512,nullptr,infoLog);
-        std::cerr<<"Vertex Shader Error:\n"<<infoLog<<std::endl;
-    }
-
-    // Fragment Shader
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader,1,&fragmentShaderSource,nullptr);
-    glCompileShader(fragmentShader);
-    glGetShaderiv(fragmentShader,GL_COMPILE_STATUS,&success);
-    if(!success) {
-        glGetShaderInfoLog(fragmentShader,512,nullptr,infoLog);
-        std::cerr<<"Fragment Shader Error:\n"<<infoLog<<std::endl;
-    }
-
-    // Shader Program
-    GLuint program = glCreateProgram();
-    glAttachShader(program,vertexShader);
-    glAttachShader(program,fragmentShader);
-    glLinkProgram(program);
-    glGetProgramiv(program,GL_LINK_STATUS,&success);
-    if(!success) {
-        glGetProgramInfoLog(program,512,nullptr,infoLog);
-        std::cerr<<"Shader Program Link Error:\n"<<infoLog<<std::endl;
-    }
-
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+// Compila e linka shaders (ou lê o binário do cache), retorna o programa
+GlProgram setupShaderProgram() {
+    GlProgram program = buildProgram(frameStages(vertexShaderSource, fragmentShaderSource));
+    bindFrameBlock(program);
     return program;
 }
 
-// Cria um VAO com um quad (2 triângulos) de tamanho unitário [0,1]x[0,1]
-GLuint createQuadVAO() {
+// Quad (2 triângulos) de tamanho unitário [0,1]x[0,1], dono do VAO e do VBO
+struct QuadMesh {
+    GlVertexArray vao;
+    GlBuffer      vbo;
+};
+QuadMesh createQuad() {
     GLfloat verts[] = {
         // first triangle
          0.0f, 0.0f, 0.0f,
@@ -133,18 +106,18 @@ GLuint createQuadVAO() {
          1.0f, 1.0f, 0.0f,
          0.0f, 1.0f, 0.0f
     };
-    GLuint VAO, VBO;
-    glGenVertexArrays(1,&VAO);
-    glGenBuffers(1,&VBO);
+    QuadMesh quad;
+    quad.vao = GlVertexArray::create();
+    quad.vbo = GlBuffer::create();
 
-    glBindVertexArray(VAO);
-      glBindBuffer(GL_ARRAY_BUFFER,VBO);
+    glBindVertexArray(quad.vao);
+      glBindBuffer(GL_ARRAY_BUFFER,quad.vbo);
       glBufferData(GL_ARRAY_BUFFER,sizeof(verts),verts,GL_STATIC_DRAW);
       glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,3*sizeof(GLfloat),(void*)0);
       glEnableVertexAttribArray(0);
     glBindVertexArray(0);
 
-    return VAO;
+    return quad;
 }
 
 // Callback de mouse: clica em um retângulo da grade para escolher sua cor
@@ -162,7 +135,9 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
         if (!grid[idx].alive) return;
 
         glm::vec3 chosen = grid[idx].color;
-        std::vector<std::pair<int, float>> removedInfo;
+        // rascunho do frame (FrameArena.h): no máximo a grade inteira
+        FrameVector<std::pair<int, float>> removedInfo;
+        removedInfo.reserve(grid.size());
 
         // verifica cada retângulo
         for (int i = 0; i < (int)grid.size(); ++i) {
@@ -236,25 +211,28 @@ int main(){
     glViewport(0,0,WINDOW_W,WINDOW_H);
 
     // 4) Compila shaders e cria VAO
-    GLuint shaderProgram = setupShaderProgram();
-    GLuint quadVAO      = createQuadVAO();
-
-    // 5) Configura projection
-    glm::mat4 projection = glm::ortho(
+    GlProgram shaderProgram = setupShaderProgram();
+    printProgramCacheStats();
+    QuadMesh  quad          = createQuad();
+
+    // 5) Configura projection (UBO de frame; a grade é estática, basta um upload)
+    FrameUniforms frame;
+    frame.init();
+    frame.data.projection = glm::ortho(
         0.0f, float(WINDOW_W),
         0.0f, float(WINDOW_H),
        -1.0f,  1.0f
     );
-    glUseProgram(shaderProgram);
-    GLint projLoc = glGetUniformLocation(shaderProgram,"projection");
-    glUniformMatrix4fv(projLoc,1,GL_FALSE,glm::value_ptr(projection));
+    frame.setViewport(0, 0, WINDOW_W, WINDOW_H);
+    frame.upload(glfwGetTime(), 0.0f);
 
     // 6) Inicializa jogo e callbacks
     initGrid();
     glfwSetMouseButtonCallback(window,mouse_button_callback);
     glfwSetKeyCallback(window,key_callback);
 
-    // 7) Main loop
+    // 7) Main loop (em debug, frames em regime não podem alocar no heap)
+    FrameHeapCheck heapCheck;
     while(!glfwWindowShouldClose(window)){
         // se esgotou tentativas ou todos removidos, encerra
         bool anyAlive=false;
@@ -265,7 +243,7 @@ int main(){
         glClear(GL_COLOR_BUFFER_BIT);
 
         glUseProgram(shaderProgram);
-        glBindVertexArray(quadVAO);
+        glBindVertexArray(quad.vao);
 
         // desenha cada retângulo
         for(auto& r: grid){
@@ -284,14 +262,23 @@ int main(){
 
         glBindVertexArray(0);
         glfwSwapBuffers(window);
+        glDeletionQueue().endFrame();
         glfwPollEvents();
+        frameArena().endFrame();
+        heapCheck.endFrame();
     }
 
     // 8) Final
     std::cout<<"\n=== Game Over ===\n"
              <<"Final Score: "<<score<<"\n"
              <<"Attempts Used: "<<attempts<<" / "<<MAX_ATTEMPTS<<"\n";
+    frameArena().print("frame");
+    heapCheck.print();
 
+    quad = QuadMesh();
+    shaderProgram.reset();
+    frame.ubo.reset();
+    glDeletionQueue().flush();
     glfwTerminate();
     return 0;
 }
@@ -0,0 +1,160 @@
+// GlHandle.h
+// Nomes GL com dono. GlBuffer, GlVertexArray, GlTexture e GlProgram só se
+// movem, e o destrutor não chama o driver: o nome vai para a fila de
+// deleção. No fim de cada frame, glDeletionQueue().endFrame() fecha os
+// nomes descartados naquele frame com uma fence e apaga os lotes cujas
+// fences a GPU já passou, sem esperar por nenhuma. Assim um objeto pode
+// morrer no meio do frame, com draws dele ainda na fila da GPU, sem que a
+// deleção force uma sincronização, e a memória fica limitada ao que foi
+// descartado nos últimos frames.
+// defer() vale de qualquer thread; endFrame() e flush() só na do GL.
+// A fila nunca é destruída, então handles globais podem morrer depois
+// dela. Depois do flush() de saída, que vem antes do glfwTerminate, ela
+// fecha: os donos que morrem no fim de main (ou na destruição dos
+// estáticos) só descartam o nome, que vai embora com o contexto.
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+enum class GlKind : uint8_t { Buffer, VertexArray, Texture, Program };
+const int GL_KIND_COUNT = 4;
+
+struct GlDeletionStats {
+    long deferred = 0, deleted = 0;
+    long batches = 0, maxPending = 0;   // lotes com fence / maior lote de nomes esperando
+};
+
+struct GlDeletionQueue {
+    GlDeletionStats stats;
+
+    void defer(GlKind k,GLuint name){
+        if(!name) return;
+        std::lock_guard<std::mutex> lk(m);
+        if(closed) return;
+        open.names[(int)k].push_back(name);
+        ++stats.deferred;
+    }
+
+    // depois do último draw do frame: não bloqueia
+    void endFrame(){
+        std::lock_guard<std::mutex> lk(m);
+        if(open.count()){
+            open.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE,0);
+            fenced.push_back(std::move(open));
+            open = Batch();
+            ++stats.batches;
+        }
+        long pending = 0;
+        for(const Batch& b : fenced) pending += b.count();
+        stats.maxPending = std::max(stats.maxPending,pending);
+        while(!fenced.empty()){
+            GLenum r = glClientWaitSync(fenced.front().fence,0,0);
+            if(r!=GL_ALREADY_SIGNALED && r!=GL_CONDITION_SATISFIED) break;
+            release(fenced.front());
+            fenced.pop_front();
+        }
+    }
+
+    // na saída: espera a GPU e apaga tudo
+    void flush(){
+        std::lock_guard<std::mutex> lk(m);
+        glFinish();
+        for(Batch& b : fenced) release(b);
+        fenced.clear();
+        release(open);
+        open = Batch();
+        closed = true;
+    }
+
+    void print() const {
+        std::printf("[gl] %ld nomes descartados, %ld apagados, %ld lotes com fence, "
+                    "no máximo %ld esperando a GPU\n",
+                    stats.deferred, stats.deleted, stats.batches, stats.maxPending);
+    }
+
+private:
+    struct Batch {
+        GLsync fence = nullptr;
+        std::vector<GLuint> names[GL_KIND_COUNT];
+        long count() const {
+            long n = 0;
+            for(const auto& v : names) n += (long)v.size();
+            return n;
+        }
+    };
+    std::mutex        m;
+    Batch             open;     // descartados no frame atual
+    std::deque<Batch> fenced;   // em ordem de fence
+    bool              closed = false;   // depois do flush() de saída
+
+    void release(Batch& b){
+        const auto& n = b.names;
+        if(!n[(int)GlKind::Buffer].empty())
+            glDeleteBuffers((GLsizei)n[(int)GlKind::Buffer].size(),n[(int)GlKind::Buffer].data());
+        if(!n[(int)GlKind::VertexArray].empty())
+            glDeleteVertexArrays((GLsizei)n[(int)GlKind::VertexArray].size(),n[(int)GlKind::VertexArray].data());
+        if(!n[(int)GlKind::Texture].empty())
+            glDeleteTextures((GLsizei)n[(int)GlKind::Texture].size(),n[(int)GlKind::Texture].data());
+        for(GLuint p : n[(int)GlKind::Program]) glDeleteProgram(p);
+        stats.deleted += b.count();
+        if(b.fence) glDeleteSync(b.fence);
+        b.fence = nullptr;
+    }
+};
+
+// nunca destruída: handles estáticos ainda podem descartar na saída
+inline GlDeletionQueue& glDeletionQueue(){
+    static GlDeletionQueue* q = new GlDeletionQueue;
+    return *q;
+}
+
+template<GlKind K>
+struct GlHandle {
+    GlHandle() = default;
+    explicit GlHandle(GLuint n) : name(n) {}     // adota um nome já criado
+    GlHandle(GlHandle&& o) noexcept : name(o.name) { o.name = 0; }
+    GlHandle& operator=(GlHandle&& o) noexcept {
+        if(this!=&o){ reset(); name = o.name; o.name = 0; }
+        return *this;
+    }
+    GlHandle(const GlHandle&) = delete;
+    GlHandle& operator=(const GlHandle&) = delete;
+    ~GlHandle(){ reset(); }
+
+    static GlHandle create(){
+        GLuint n = 0;
+        if constexpr(K==GlKind::Buffer)           glGenBuffers(1,&n);
+        else if constexpr(K==GlKind::VertexArray) glGenVertexArrays(1,&n);
+        else if constexpr(K==GlKind::Texture)     glGenTextures(1,&n);
+        else                                      n = glCreateProgram();
+        return GlHandle(n);
+    }
+
+    GLuint get() const { return name; }
+    operator GLuint() const { return name; }
+
+    // o nome atual vai para a fila; passa a guardar n
+    void reset(GLuint n = 0){
+        if(name) glDeletionQueue().defer(K,name);
+        name = n;
+    }
+    // devolve o nome sem apagá-lo
+    GLuint release(){ return std::exchange(name,0); }
+
+private:
+    GLuint name = 0;
+};
+
+using GlBuffer      = GlHandle<GlKind::Buffer>;
+using GlVertexArray = GlHandle<GlKind::VertexArray>;
+using GlTexture     = GlHandle<GlKind::Texture>;
+using GlProgram     = GlHandle<GlKind::Program>;
@@ -0,0 +1,376 @@
+// GpuTrack.h
+// Contabilidade dos objetos GL. installGpuTracking(), logo depois do
+// gladLoadGLLoader, troca os ponteiros do glad de glGen*/glDelete*/
+// glCreate*, glBufferData/glBufferStorage, glTexImage2D/3D/
+// glCompressedTexImage2D e glGenerateMipmap por versões que anotam antes
+// de chamar a original, então nenhum ponto de chamada muda. Por categoria
+// ficam os objetos vivos, os criados no total e os bytes vivos (buffers
+// pelo tamanho alocado; texturas por nível, pelo formato interno, com os
+// níveis gerados a partir do nível 0, sem contar o que o driver
+// acrescenta). O objeto afetado por glBufferData/glTexImage é o ligado ao
+// alvo, que vem de uma cópia das ligações mantida pelos ganchos
+// de glBind*/glActiveTexture, sem glGet* (que serializa drivers com thread
+// própria) nos caminhos quentes. Um mutex protege as tabelas: a compilação
+// em lote e o render também criam objetos em outras threads.
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+
+enum class GpuKind { Buffer, Texture, VertexArray, Program, Shader };
+const int GPU_KIND_COUNT = 5;
+
+inline const char* gpuKindName(GpuKind k){
+    static const char* const names[GPU_KIND_COUNT] = { "buffers", "texturas", "VAOs", "programas", "shaders" };
+    return names[(int)k];
+}
+
+struct GpuKindStats {
+    long    live = 0, created = 0;
+    int64_t bytes = 0, peak = 0;
+};
+
+// cópia das ligações do contexto. Uma só: as demos usam um contexto de cada
+// vez para buffers e texturas (o do ProgramBatch só compila), e só a thread
+// que tem o contexto mexe nela, então fica fora do mutex
+const int GPU_SHADOW_UNITS = 32;
+
+struct GpuBindings {
+    GLuint buffers[6] = {};                             // por bufferSlot()
+    GLuint textures[GPU_SHADOW_UNITS][3] = {};          // por unidade e textureSlot()
+    int    unit = 0;
+    GLuint vao  = 0;
+    std::unordered_map<GLuint,GLuint> elements;         // VAO -> GL_ELEMENT_ARRAY_BUFFER (estado do VAO)
+};
+
+inline int bufferSlot(GLenum target){
+    return target==GL_ARRAY_BUFFER        ? 0 : target==GL_UNIFORM_BUFFER     ? 1
+         : target==GL_TEXTURE_BUFFER      ? 2 : target==GL_PIXEL_UNPACK_BUFFER ? 3
+         : target==GL_COPY_WRITE_BUFFER   ? 4 : target==GL_COPY_READ_BUFFER    ? 5 : -1;
+}
+
+inline int textureSlot(GLenum target){
+    return target==GL_TEXTURE_2D ? 0 : target==GL_TEXTURE_2D_ARRAY ? 1 : target==GL_TEXTURE_3D ? 2 : -1;
+}
+
+struct GpuTracker {
+    std::mutex   m;
+    GpuKindStats kinds[GPU_KIND_COUNT];
+    std::unordered_map<GLuint,int64_t>   names[GPU_KIND_COUNT];     // vivos -> bytes
+    std::unordered_map<uint64_t,int64_t> levels;                    // (textura, nível) -> bytes
+    struct TexBase { int w = 0, h = 0, d = 1, bpp = 4; bool layered = false; };
+    std::unordered_map<GLuint,TexBase>   bases;                     // nível 0, para glGenerateMipmap
+    GpuBindings bindings;
+    bool installed = false;
+
+    // funções originais do glad
+    PFNGLGENBUFFERSPROC           genBuffers = nullptr;
+    PFNGLDELETEBUFFERSPROC        deleteBuffers = nullptr;
+    PFNGLBUFFERDATAPROC           bufferData = nullptr;
+    PFNGLBUFFERSTORAGEPROC        bufferStorage = nullptr;
+    PFNGLBINDBUFFERPROC           bindBuffer = nullptr;
+    PFNGLBINDBUFFERBASEPROC       bindBufferBase = nullptr;
+    PFNGLBINDBUFFERRANGEPROC      bindBufferRange = nullptr;
+    PFNGLGENTEXTURESPROC          genTextures = nullptr;
+    PFNGLDELETETEXTURESPROC       deleteTextures = nullptr;
+    PFNGLBINDTEXTUREPROC          bindTexture = nullptr;
+    PFNGLACTIVETEXTUREPROC        activeTexture = nullptr;
+    PFNGLTEXIMAGE2DPROC           texImage2D = nullptr;
+    PFNGLTEXIMAGE3DPROC           texImage3D = nullptr;
+    PFNGLCOMPRESSEDTEXIMAGE2DPROC compressedTexImage2D = nullptr;
+    PFNGLGENERATEMIPMAPPROC       generateMipmap = nullptr;
+    PFNGLGENVERTEXARRAYSPROC      genVertexArrays = nullptr;
+    PFNGLDELETEVERTEXARRAYSPROC   deleteVertexArrays = nullptr;
+    PFNGLBINDVERTEXARRAYPROC      bindVertexArray = nullptr;
+    PFNGLCREATEPROGRAMPROC        createProgram = nullptr;
+    PFNGLDELETEPROGRAMPROC        deleteProgram = nullptr;
+    PFNGLCREATESHADERPROC         createShader = nullptr;
+    PFNGLDELETESHADERPROC         deleteShader = nullptr;
+
+    void created(GpuKind k,GLuint name){
+        if(!name) return;
+        std::lock_guard<std::mutex> lk(m);
+        if(!names[(int)k].emplace(name,0).second) return;
+        ++kinds[(int)k].live;
+        ++kinds[(int)k].created;
+    }
+
+    void deleted(GpuKind k,GLuint name){
+        std::lock_guard<std::mutex> lk(m);
+        auto it = names[(int)k].find(name);
+        if(it==names[(int)k].end()) return;
+        GpuKindStats& s = kinds[(int)k];
+        s.bytes -= it->second;
+        --s.live;
+        names[(int)k].erase(it);
+        if(k==GpuKind::Texture){
+            for(uint64_t l=0;l<32;++l) levels.erase((uint64_t)name<<8 | l);
+            bases.erase(name);
+        }
+    }
+
+    // novo tamanho de um buffer, ou de um nível de textura
+    void resized(GpuKind k,GLuint name,int level,int64_t bytes){
+        std::lock_guard<std::mutex> lk(m);
+        resize(k,name,level,bytes);
+    }
+
+    // nível 0 de uma textura não comprimida: guarda as dimensões
+    void texBase(GLuint name,int level,int w,int h,int d,int bpp,bool layered){
+        std::lock_guard<std::mutex> lk(m);
+        if(level==0 && names[(int)GpuKind::Texture].count(name)) bases[name] = { w, h, d, bpp, layered };
+        resize(GpuKind::Texture,name,level,(int64_t)w*h*d*bpp);
+    }
+
+    // glGenerateMipmap: os níveis 1.. até 1x1 a partir do nível 0
+    void mipmapped(GLuint name){
+        std::lock_guard<std::mutex> lk(m);
+        auto b = bases.find(name);
+        if(b==bases.end()) return;
+        TexBase t = b->second;
+        for(int l=1; t.w>1 || t.h>1 || (!t.layered && t.d>1); ++l){
+            t.w = std::max(1,t.w/2);
+            t.h = std::max(1,t.h/2);
+            if(!t.layered) t.d = std::max(1,t.d/2);
+            resize(GpuKind::Texture,name,l,(int64_t)t.w*t.h*t.d*t.bpp);
+        }
+    }
+
+    GpuKindStats get(GpuKind k){
+        std::lock_guard<std::mutex> lk(m);
+        return kinds[(int)k];
+    }
+
+private:
+    void resize(GpuKind k,GLuint name,int level,int64_t bytes){
+        auto it = names[(int)k].find(name);
+        if(it==names[(int)k].end()) return;
+        int64_t delta = bytes;
+        if(k==GpuKind::Texture){
+            int64_t& lv = levels[(uint64_t)name<<8 | (uint64_t)level];
+            delta -= lv;
+            lv = bytes;
+        } else delta -= it->second;
+        it->second += delta;
+        GpuKindStats& s = kinds[(int)k];
+        s.bytes += delta;
+        s.peak = std::max(s.peak,s.bytes);
+    }
+};
+
+inline GpuTracker& gpuTracker(){
+    static GpuTracker t;
+    return t;
+}
+
+// objeto ligado ao alvo no contexto atual (0 se o alvo não é rastreado)
+inline GLuint boundBuffer(GLenum target){
+    GpuBindings& b = gpuTracker().bindings;
+    if(target==GL_ELEMENT_ARRAY_BUFFER){
+        auto it = b.elements.find(b.vao);
+        return it==b.elements.end() ? 0 : it->second;
+    }
+    int s = bufferSlot(target);
+    return s<0 ? 0 : b.buffers[s];
+}
+
+inline GLuint boundTexture(GLenum target){
+    GpuBindings& b = gpuTracker().bindings;
+    int s = textureSlot(target);
+    return s<0 || b.unit>=GPU_SHADOW_UNITS ? 0 : b.textures[b.unit][s];
+}
+
+// bytes por texel dos formatos usados; o resto conta como RGBA8
+inline int texelBytes(GLint internalFormat){
+    switch(internalFormat){
+        case GL_R8: case GL_RED:                          return 1;
+        case GL_RG8: case GL_RG:                          return 2;
+        case GL_RGB8: case GL_RGB:                        return 3;
+        case GL_RGBA16F:                                  return 8;
+        case GL_RGBA32F:                                  return 16;
+        default:                                          return 4;
+    }
+}
+
+// ——————————————————————
+// Ganchos: anotam e chamam a original
+
+inline void APIENTRY trackGenBuffers(GLsizei n,GLuint* b){
+    GpuTracker& t = gpuTracker();
+    t.genBuffers(n,b);
+    for(GLsizei i=0;i<n;++i) t.created(GpuKind::Buffer,b[i]);
+}
+inline void APIENTRY trackDeleteBuffers(GLsizei n,const GLuint* b){
+    GpuTracker& t = gpuTracker();
+    GpuBindings& sh = t.bindings;
+    for(GLsizei i=0;i<n;++i){
+        t.deleted(GpuKind::Buffer,b[i]);
+        for(GLuint& x : sh.buffers) if(x==b[i]) x = 0;          // apagar desliga
+        for(auto& e : sh.elements)  if(e.second==b[i]) e.second = 0;
+    }
+    t.deleteBuffers(n,b);
+}
+inline void APIENTRY trackBindBuffer(GLenum target,GLuint b){
+    GpuTracker& t = gpuTracker();
+    if(target==GL_ELEMENT_ARRAY_BUFFER) t.bindings.elements[t.bindings.vao] = b;
+    else if(int s = bufferSlot(target); s>=0) t.bindings.buffers[s] = b;
+    t.bindBuffer(target,b);
+}
+// também liga no alvo genérico
+inline void APIENTRY trackBindBufferBase(GLenum target,GLuint index,GLuint b){
+    GpuTracker& t = gpuTracker();
+    if(int s = bufferSlot(target); s>=0) t.bindings.buffers[s] = b;
+    t.bindBufferBase(target,index,b);
+}
+inline void APIENTRY trackBindBufferRange(GLenum target,GLuint index,GLuint b,GLintptr offset,GLsizeiptr size){
+    GpuTracker& t = gpuTracker();
+    if(int s = bufferSlot(target); s>=0) t.bindings.buffers[s] = b;
+    t.bindBufferRange(target,index,b,offset,size);
+}
+inline void APIENTRY trackBufferData(GLenum target,GLsizeiptr size,const void* data,GLenum usage){
+    GpuTracker& t = gpuTracker();
+    t.resized(GpuKind::Buffer,boundBuffer(target),0,size);
+    t.bufferData(target,size,data,usage);
+}
+inline void APIENTRY trackBufferStorage(GLenum target,GLsizeiptr size,const void* data,GLbitfield flags){
+    GpuTracker& t = gpuTracker();
+    t.resized(GpuKind::Buffer,boundBuffer(target),0,size);
+    t.bufferStorage(target,size,data,flags);
+}
+inline void APIENTRY trackGenTextures(GLsizei n,GLuint* tex){
+    GpuTracker& t = gpuTracker();
+    t.genTextures(n,tex);
+    for(GLsizei i=0;i<n;++i) t.created(GpuKind::Texture,tex[i]);
+}
+inline void APIENTRY trackDeleteTextures(GLsizei n,const GLuint* tex){
+    GpuTracker& t = gpuTracker();
+    for(GLsizei i=0;i<n;++i){
+        t.deleted(GpuKind::Texture,tex[i]);
+        for(auto& unit : t.bindings.textures)
+            for(GLuint& x : unit) if(x==tex[i]) x = 0;
+    }
+    t.deleteTextures(n,tex);
+}
+inline void APIENTRY trackBindTexture(GLenum target,GLuint tex){
+    GpuTracker& t = gpuTracker();
+    GpuBindings& sh = t.bindings;
+    if(int s = textureSlot(target); s>=0 && sh.unit<GPU_SHADOW_UNITS) sh.textures[sh.unit][s] = tex;
+    t.bindTexture(target,tex);
+}
+inline void APIENTRY trackActiveTexture(GLenum unit){
+    GpuTracker& t = gpuTracker();
+    t.bindings.unit = (int)(unit - GL_TEXTURE0);
+    t.activeTexture(unit);
+}
+inline void APIENTRY trackTexImage2D(GLenum target,GLint level,GLint internalFormat,GLsizei w,GLsizei h,
+                                     GLint border,GLenum format,GLenum type,const void* px){
+    GpuTracker& t = gpuTracker();
+    t.texBase(boundTexture(target),level,w,h,1,texelBytes(internalFormat),false);
+    t.texImage2D(target,level,internalFormat,w,h,border,format,type,px);
+}
+inline void APIENTRY trackTexImage3D(GLenum target,GLint level,GLint internalFormat,GLsizei w,GLsizei h,GLsizei d,
+                                     GLint border,GLenum format,GLenum type,const void* px){
+    GpuTracker& t = gpuTracker();
+    t.texBase(boundTexture(target),level,w,h,d,texelBytes(internalFormat),target==GL_TEXTURE_2D_ARRAY);
+    t.texImage3D(target,level,internalFormat,w,h,d,border,format,type,px);
+}
+inline void APIENTRY trackCompressedTexImage2D(GLenum target,GLint level,GLenum internalFormat,GLsizei w,GLsizei h,
+                                               GLint border,GLsizei imageSize,const void* data){
+    GpuTracker& t = gpuTracker();
+    t.resized(GpuKind::Texture,boundTexture(target),level,imageSize);
+    t.compressedTexImage2D(target,level,internalFormat,w,h,border,imageSize,data);
+}
+// os níveis gerados contam como se tivessem subido um a um
+inline void APIENTRY trackGenerateMipmap(GLenum target){
+    GpuTracker& t = gpuTracker();
+    t.mipmapped(boundTexture(target));
+    t.generateMipmap(target);
+}
+inline void APIENTRY trackGenVertexArrays(GLsizei n,GLuint* v){
+    GpuTracker& t = gpuTracker();
+    t.genVertexArrays(n,v);
+    for(GLsizei i=0;i<n;++i) t.created(GpuKind::VertexArray,v[i]);
+}
+inline void APIENTRY trackDeleteVertexArrays(GLsizei n,const GLuint* v){
+    GpuTracker& t = gpuTracker();
+    for(GLsizei i=0;i<n;++i){
+        t.deleted(GpuKind::VertexArray,v[i]);
+        t.bindings.elements.erase(v[i]);
+        if(t.bindings.vao==v[i]) t.bindings.vao = 0;
+    }
+    t.deleteVertexArrays(n,v);
+}
+inline void APIENTRY trackBindVertexArray(GLuint v){
+    GpuTracker& t = gpuTracker();
+    t.bindings.vao = v;
+    t.bindVertexArray(v);
+}
+inline GLuint APIENTRY trackCreateProgram(){
+    GpuTracker& t = gpuTracker();
+    GLuint p = t.createProgram();
+    t.created(GpuKind::Program,p);
+    return p;
+}
+inline void APIENTRY trackDeleteProgram(GLuint p){
+    GpuTracker& t = gpuTracker();
+    t.deleted(GpuKind::Program,p);
+    t.deleteProgram(p);
+}
+inline GLuint APIENTRY trackCreateShader(GLenum type){
+    GpuTracker& t = gpuTracker();
+    GLuint s = t.createShader(type);
+    t.created(GpuKind::Shader,s);
+    return s;
+}
+inline void APIENTRY trackDeleteShader(GLuint s){
+    GpuTracker& t = gpuTracker();
+    t.deleted(GpuKind::Shader,s);
+    t.deleteShader(s);
+}
+
+// depois do gladLoadGLLoader e antes de criar qualquer objeto
+inline void installGpuTracking(){
+    GpuTracker& t = gpuTracker();
+    if(t.installed) return;
+    t.installed = true;
+    #define TRACK(orig,field,hook) t.field = orig; if(orig) orig = hook
+    TRACK(glad_glGenBuffers,           genBuffers,           trackGenBuffers);
+    TRACK(glad_glDeleteBuffers,        deleteBuffers,        trackDeleteBuffers);
+    TRACK(glad_glBufferData,           bufferData,           trackBufferData);
+    TRACK(glad_glBufferStorage,        bufferStorage,        trackBufferStorage);
+    TRACK(glad_glBindBuffer,           bindBuffer,           trackBindBuffer);
+    TRACK(glad_glBindBufferBase,       bindBufferBase,       trackBindBufferBase);
+    TRACK(glad_glBindBufferRange,      bindBufferRange,      trackBindBufferRange);
+    TRACK(glad_glGenTextures,          genTextures,          trackGenTextures);
+    TRACK(glad_glDeleteTextures,       deleteTextures,       trackDeleteTextures);
+    TRACK(glad_glBindTexture,          bindTexture,          trackBindTexture);
+    TRACK(glad_glActiveTexture,        activeTexture,        trackActiveTexture);
+    TRACK(glad_glTexImage2D,           texImage2D,           trackTexImage2D);
+    TRACK(glad_glTexImage3D,           texImage3D,           trackTexImage3D);
+    TRACK(glad_glCompressedTexImage2D, compressedTexImage2D, trackCompressedTexImage2D);
+    TRACK(glad_glGenerateMipmap,       generateMipmap,       trackGenerateMipmap);
+    TRACK(glad_glGenVertexArrays,      genVertexArrays,      trackGenVertexArrays);
+    TRACK(glad_glDeleteVertexArrays,   deleteVertexArrays,   trackDeleteVertexArrays);
+    TRACK(glad_glBindVertexArray,      bindVertexArray,      trackBindVertexArray);
+    TRACK(glad_glCreateProgram,        createProgram,        trackCreateProgram);
+    TRACK(glad_glDeleteProgram,        deleteProgram,        trackDeleteProgram);
+    TRACK(glad_glCreateShader,         createShader,         trackCreateShader);
+    TRACK(glad_glDeleteShader,         deleteShader,         trackDeleteShader);
+    #undef TRACK
+}
+
+inline void printGpuReport(){
+    GpuTracker& t = gpuTracker();
+    std::printf("[gpu] %-10s %8s %8s %10s %10s\n","categoria","vivos","criados","KB vivos","KB pico");
+    for(int i=0;i<GPU_KIND_COUNT;++i){
+        GpuKindStats s = t.get((GpuKind)i);
+        std::printf("[gpu] %-10s %8ld %8ld %10.1f %10.1f\n", gpuKindName((GpuKind)i),
+                    s.live, s.created, s.bytes/1024.0, s.peak/1024.0);
+    }
+}
@@ -0,0 +1,162 @@
+// HeapCount.h
+// Contabilidade do heap geral. Substitui o operator new global, então entra
+// em um único .cpp por executável (cada demo é um .cpp só). Cada bloco leva
+// um cabeçalho com o tamanho e a etiqueta (MemTag) da thread no momento da
+// alocação, e por etiqueta ficam os blocos e bytes vivos, o pico e o total
+// de alocações. heapAlloc/heapRealloc/heapFree são o mesmo caminho para
+// quem usa malloc (STBI_MALLOC & cia.).
+// FrameHeapCheck conta os frames depois do aquecimento que alocaram e, em
+// debug, falha no primeiro; um frame que cria estado que fica (um
+// triângulo novo, por exemplo) avisa com allow(). FrameArenaTest faz a
+// mesma verificação só na CPU, a cada build.
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+enum class MemTag : uint8_t { General, Images, Sprites, Shaders, Render, Jobs };
+const int MEM_TAG_COUNT = 6;
+
+inline const char* memTagName(MemTag t){
+    static const char* const names[MEM_TAG_COUNT] = { "geral", "imagens", "sprites", "shaders", "render", "tarefas" };
+    return names[(int)t];
+}
+
+struct HeapTagStats {
+    std::atomic<long>    allocs{0}, live{0};
+    std::atomic<int64_t> bytes{0}, peak{0};
+};
+
+inline HeapTagStats       heapTags[MEM_TAG_COUNT];
+inline std::atomic<long>  heapNews{0};              // chamadas ao operator new
+inline thread_local MemTag currentMemTag = MemTag::General;
+
+// etiqueta da thread enquanto o escopo vive
+struct MemTagScope {
+    MemTag prev;
+    explicit MemTagScope(MemTag t) : prev(currentMemTag) { currentMemTag = t; }
+    ~MemTagScope(){ currentMemTag = prev; }
+};
+
+// cabeçalho de 16 bytes: mantém o alinhamento do malloc
+struct HeapHeader {
+    size_t  size;
+    uint8_t tag;
+    uint8_t pad[16 - sizeof(size_t) - 1];
+};
+static_assert(sizeof(HeapHeader) == 16, "HeapHeader precisa preservar o alinhamento de max_align_t");
+
+inline void heapCount(HeapHeader* h,int64_t sign){
+    HeapTagStats& t = heapTags[h->tag];
+    int64_t b = t.bytes.fetch_add(sign*(int64_t)h->size,std::memory_order_relaxed) + sign*(int64_t)h->size;
+    t.live.fetch_add((long)sign,std::memory_order_relaxed);
+    if(sign > 0){
+        t.allocs.fetch_add(1,std::memory_order_relaxed);
+        int64_t pk = t.peak.load(std::memory_order_relaxed);
+        while(b > pk && !t.peak.compare_exchange_weak(pk,b,std::memory_order_relaxed)) {}
+    }
+}
+
+inline void* heapAlloc(size_t n){
+    HeapHeader* h = (HeapHeader*)std::malloc(sizeof(HeapHeader) + n);
+    if(!h) return nullptr;
+    h->size = n;
+    h->tag  = (uint8_t)currentMemTag;
+    heapCount(h,+1);
+    return h + 1;
+}
+
+inline void heapFree(void* p){
+    if(!p) return;
+    HeapHeader* h = (HeapHeader*)p - 1;
+    heapCount(h,-1);
+    std::free(h);
+}
+
+// o bloco muda para a etiqueta atual
+inline void* heapRealloc(void* p,size_t n){
+    if(!p) return heapAlloc(n);
+    HeapHeader* h = (HeapHeader*)p - 1;
+    heapCount(h,-1);
+    HeapHeader* r = (HeapHeader*)std::realloc(h,sizeof(HeapHeader) + n);
+    if(!r){ heapCount(h,+1); return nullptr; }
+    r->size = n;
+    r->tag  = (uint8_t)currentMemTag;
+    heapCount(r,+1);
+    return r + 1;
+}
+
+// os substitutos não podem ser inline; fora de linha, o gcc também não
+// confunde o cabeçalho antes do bloco com acesso fora do objeto
+#if defined(_MSC_VER)
+#define HEAP_NOINLINE __declspec(noinline)
+#else
+#define HEAP_NOINLINE __attribute__((noinline))
+#endif
+
+HEAP_NOINLINE void* operator new(std::size_t n){
+    heapNews.fetch_add(1,std::memory_order_relaxed);
+    if(void* p = heapAlloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+HEAP_NOINLINE void operator delete(void* p) noexcept { heapFree(p); }
+HEAP_NOINLINE void operator delete(void* p,std::size_t) noexcept { heapFree(p); }
+
+struct HeapTotals { long live = 0, allocs = 0; int64_t bytes = 0; };
+
+inline HeapTotals heapTotals(){
+    HeapTotals t;
+    for(const HeapTagStats& s : heapTags){
+        t.live   += s.live.load();
+        t.allocs += s.allocs.load();
+        t.bytes  += s.bytes.load();
+    }
+    return t;
+}
+
+inline void printHeapReport(){
+    std::printf("[heap] %-8s %10s %10s %10s %10s\n","etiqueta","vivos","KB vivos","KB pico","alocações");
+    for(int i=0;i<MEM_TAG_COUNT;++i){
+        const HeapTagStats& s = heapTags[i];
+        if(!s.allocs.load()) continue;
+        std::printf("[heap] %-8s %10ld %10.1f %10.1f %10ld\n", memTagName((MemTag)i),
+                    s.live.load(), s.bytes.load()/1024.0, s.peak.load()/1024.0, s.allocs.load());
+    }
+}
+
+struct FrameHeapCheck {
+    long warmup  = 3;           // frames iniciais liberados (caches, primeiros estouros do arena)
+    long frames  = 0, steady = 0, allowed = 0;
+    long violations = 0;        // frames em regime que alocaram (também sem assert)
+    long mark    = heapNews.load();
+    bool allowNow = false;
+
+    // este frame pode alocar: cria estado persistente
+    void allow(){ allowNow = true; }
+
+    void endFrame(){
+        long now = heapNews.load(std::memory_order_relaxed);
+        if(frames >= warmup){
+            if(allowNow) ++allowed;
+            else if(now != mark){
+                ++violations;
+                std::fprintf(stderr,"[heap] frame %ld: %ld alocações no heap em regime\n",frames,now-mark);
+                assert(!"frame em regime alocou no heap");
+            }
+            else ++steady;
+        }
+        mark = now;
+        allowNow = false;
+        ++frames;
+    }
+
+    void print() const {
+        std::printf("[heap] %ld frames em regime sem alocar no heap (%ld com estado novo liberados), "
+                    "%ld alocações no total\n", steady, allowed, heapNews.load());
+    }
+};
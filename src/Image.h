@@ -0,0 +1,128 @@
+// Image.h
+// Imagem RGBA8 em memória e as operações de CPU usadas pelo pipeline de
+// texturas: redução 2x2 por média de área (SSE2 / NEON quando disponível,
+// dividida por linhas entre as threads do JobSystem) e a política "menor variante que
+// cobre o alvo". Não depende de GL, então também serve às ferramentas offline.
+
+#pragma once
+
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+  #include <emmintrin.h>
+  #define TL_SSE2 1
+#elif defined(__ARM_NEON)
+  #include <arm_neon.h>
+  #define TL_NEON 1
+#endif
+
+// imagem RGBA8 em memória (linha 0 = base da textura, como o stbi com flip)
+struct Image {
+    int w = 0, h = 0;
+    std::vector<unsigned char> px;
+
+    Image() = default;
+    Image(int W,int H) : w(W), h(H), px((size_t)W*H*4) {}
+
+    static Image fromRGBA(int W,int H,const unsigned char* data){
+        Image img;
+        img.w = W; img.h = H;
+        img.px.assign(data, data + (size_t)W*H*4);
+        return img;
+    }
+    unsigned char*       row(int y)       { return px.data() + (size_t)y*w*4; }
+    const unsigned char* row(int y) const { return px.data() + (size_t)y*w*4; }
+    size_t bytes() const { return px.size(); }
+};
+
+// bytes da cadeia completa de mipmaps (nível 0 até 1x1)
+inline size_t mipChainBytes(int w,int h,int bpp=4){
+    size_t total = 0;
+    for(;;){
+        total += (size_t)w*h*bpp;
+        if(w==1 && h==1) break;
+        w = std::max(1,w/2);
+        h = std::max(1,h/2);
+    }
+    return total;
+}
+
+// ——————————————————————
+// Redução 2x2 por média de área
+
+// média de 2x2 pixels para as colunas [x0,x1) da linha de saída
+inline void downsampleRowScalar(const unsigned char* r0,const unsigned char* r1,
+                                unsigned char* out,int x0,int x1,int srcW){
+    for(int x=x0; x<x1; ++x){
+        int sx0 = std::min(2*x,   srcW-1);
+        int sx1 = std::min(2*x+1, srcW-1);
+        for(int c=0;c<4;++c){
+            int s = r0[sx0*4+c] + r0[sx1*4+c] + r1[sx0*4+c] + r1[sx1*4+c];
+            out[x*4+c] = (unsigned char)((s + 2) >> 2);
+        }
+    }
+}
+
+inline void downsampleRow(const unsigned char* r0,const unsigned char* r1,
+                          unsigned char* out,int dstW,int srcW){
+    int x = 0;
+#if defined(TL_SSE2)
+    // 4 pixels de entrada por linha -> 2 pixels de saída
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two  = _mm_set1_epi16(2);
+    for(; x+2<=dstW && 2*x+4<=srcW; x+=2){
+        __m128i a = _mm_loadu_si128((const __m128i*)(r0 + x*8));
+        __m128i b = _mm_loadu_si128((const __m128i*)(r1 + x*8));
+        __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a,zero), _mm_unpacklo_epi8(b,zero));
+        __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a,zero), _mm_unpackhi_epi8(b,zero));
+        lo = _mm_add_epi16(lo, _mm_srli_si128(lo,8));   // p0+p1 nas 4 lanes baixas
+        hi = _mm_add_epi16(hi, _mm_srli_si128(hi,8));   // p2+p3
+        __m128i s = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo,hi), two), 2);
+        _mm_storel_epi64((__m128i*)(out + x*4), _mm_packus_epi16(s,zero));
+    }
+#elif defined(TL_NEON)
+    for(; x+2<=dstW && 2*x+4<=srcW; x+=2){
+        uint8x16_t a = vld1q_u8(r0 + x*8);
+        uint8x16_t b = vld1q_u8(r1 + x*8);
+        uint16x8_t lo = vaddl_u8(vget_low_u8(a),  vget_low_u8(b));
+        uint16x8_t hi = vaddl_u8(vget_high_u8(a), vget_high_u8(b));
+        uint16x8_t s  = vcombine_u16(vadd_u16(vget_low_u16(lo), vget_high_u16(lo)),
+                                     vadd_u16(vget_low_u16(hi), vget_high_u16(hi)));
+        vst1_u8(out + x*4, vrshrn_n_u16(s,2));
+    }
+#endif
+    downsampleRowScalar(r0,r1,out,x,dstW,srcW);
+}
+
+// reduz a imagem pela metade (mínimo 1x1) em até maxThreads pedaços (0 = sem limite)
+inline Image downsample2x(const Image& src,unsigned maxThreads=0){
+    Image dst(std::max(1,src.w/2), std::max(1,src.h/2));
+    auto work = [&](int y0,int y1){
+        for(int y=y0; y<y1; ++y){
+            const unsigned char* r0 = src.row(std::min(2*y,   src.h-1));
+            const unsigned char* r1 = src.row(std::min(2*y+1, src.h-1));
+            downsampleRow(r0,r1,dst.row(y),dst.w,src.w);
+        }
+    };
+
+    // não vale a pena abaixo de ~32 linhas
+    int grain = maxThreads ? std::max(32,(dst.h + (int)maxThreads - 1) / (int)maxThreads) : 32;
+    jobSystem().parallelFor(0,dst.h,grain,work);
+    return dst;
+}
+
+// menor variante (metades sucessivas) que ainda cobre targetW x targetH;
+// target <= 0 em um eixo significa "sem restrição" naquele eixo
+inline Image fitToTarget(Image img,int targetW,int targetH){
+    if(targetW<=0 && targetH<=0) return img;
+    auto covers = [&](int w,int h){
+        return (targetW<=0 || w>=targetW) && (targetH<=0 || h>=targetH);
+    };
+    while(img.w>1 && img.h>1 && covers(img.w/2, img.h/2))
+        img = downsample2x(img);
+    return img;
+}
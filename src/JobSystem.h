@@ -0,0 +1,177 @@
+// JobSystem.h
+// Agendador de tarefas com roubo de trabalho, compartilhado por carga,
+// mips, animação, culling e montagem de lotes. Cada thread do sistema tem
+// a sua fila dupla (a fila 0 é de quem não é do sistema, como a thread
+// principal): quem submete empilha no fim da própria fila e desempilha do
+// fim, o mais recente e ainda quente no cache; quem fica sem trabalho
+// rouba do começo da fila de outra thread, onde estão os pedaços maiores
+// do parallelFor. Cada fila tem o seu mutex, disputado só no roubo.
+// JobCounter conta as tarefas de um grupo: wait() executa tarefas enquanto
+// o grupo não termina, em vez de bloquear, e uma tarefa submetida com
+// after só entra na fila quando aquele contador zera.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct JobCounter;
+
+struct Job {
+    std::function<void()> fn;
+    JobCounter* done = nullptr;
+};
+
+struct JobCounter {
+    std::atomic<int> pending{0};
+
+    bool idle() const { return pending.load(std::memory_order_acquire)==0; }
+
+private:
+    friend struct JobSystem;
+    std::mutex       m;
+    std::vector<Job> waiting;           // submetidas com after = este contador
+};
+
+struct JobSystem;
+inline thread_local const JobSystem* jobOwner = nullptr;   // sistema da thread atual
+inline thread_local int              jobIndex = 0;         // fila dela nesse sistema
+
+struct JobSystem {
+    // threads = total, contando quem chama wait(); 0 = uma por núcleo
+    explicit JobSystem(unsigned threads = 0){
+        unsigned n = threads ? threads : std::max(1u,std::thread::hardware_concurrency());
+        for(unsigned i=0;i<n;++i) queues.emplace_back(new Queue);
+        for(unsigned i=1;i<n;++i) workers.emplace_back([this,i]{ workerLoop((int)i); });
+    }
+    ~JobSystem(){
+        quit = true;
+        wake.notify_all();
+        for(auto& t : workers) t.join();
+    }
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned threads() const { return (unsigned)queues.size(); }
+    long executed() const { return nExecuted.load(); }
+    long stolen()   const { return nStolen.load(); }
+
+    void submit(std::function<void()> fn,JobCounter* done = nullptr,JobCounter* after = nullptr){
+        Job j{std::move(fn),done};
+        if(done) done->pending.fetch_add(1,std::memory_order_relaxed);
+        if(after){
+            std::lock_guard<std::mutex> lk(after->m);
+            if(!after->idle()){ after->waiting.push_back(std::move(j)); return; }
+        }
+        push(std::move(j));
+    }
+
+    // ajuda a esvaziar as filas até o contador zerar
+    void wait(JobCounter& c){
+        while(!c.idle()){
+            Job j;
+            if(pop(j)) execute(j);
+            else       std::this_thread::yield();
+        }
+        std::lock_guard<std::mutex> lk(c.m);    // quem zerou já soltou o contador
+    }
+
+    // fn(i0,i1) em pedaços de até grain; as metades de cima vão para a fila
+    template<class F>
+    void parallelFor(int begin,int end,int grain,const F& fn){
+        if(end<=begin) return;
+        grain = std::max(1,grain);
+        if(end-begin<=grain || threads()==1){ fn(begin,end); return; }
+        JobCounter c;
+        std::function<void(int,int)> split = [&](int a,int b){
+            while(b-a > grain){
+                int mid = a + (b-a)/2;
+                submit([&split,mid,b]{ split(mid,b); },&c);
+                b = mid;
+            }
+            fn(a,b);
+        };
+        split(begin,end);
+        wait(c);
+    }
+
+private:
+    struct Queue { std::mutex m; std::deque<Job> jobs; };
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread>            workers;
+    std::atomic<bool> quit{false};
+    std::atomic<int>  queued{0};
+    std::atomic<long> nExecuted{0}, nStolen{0};
+    std::mutex              sleepM;
+    std::condition_variable wake;
+
+    int self() const { return jobOwner==this ? jobIndex : 0; }
+
+    void push(Job&& j){
+        Queue& q = *queues[self()];
+        { std::lock_guard<std::mutex> lk(q.m); q.jobs.push_back(std::move(j)); }
+        queued.fetch_add(1,std::memory_order_release);
+        wake.notify_one();
+    }
+
+    // do fim da própria fila ou do começo de outra
+    bool pop(Job& j){
+        if(!queued.load(std::memory_order_acquire)) return false;
+        int n = (int)queues.size(), me = self();
+        for(int k=0;k<n;++k){
+            Queue& q = *queues[(me+k)%n];
+            std::lock_guard<std::mutex> lk(q.m);
+            if(q.jobs.empty()) continue;
+            if(k==0){ j = std::move(q.jobs.back());  q.jobs.pop_back(); }
+            else    { j = std::move(q.jobs.front()); q.jobs.pop_front(); ++nStolen; }
+            queued.fetch_sub(1,std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void execute(Job& j){
+        j.fn();
+        ++nExecuted;
+        if(j.done) finish(*j.done);
+    }
+
+    // último do grupo libera as tarefas que esperavam por ele; o contador
+    // pode ser destruído assim que zera, então só se mexe nele com o mutex
+    void finish(JobCounter& c){
+        std::vector<Job> ready;
+        {
+            std::lock_guard<std::mutex> lk(c.m);
+            if(c.pending.fetch_sub(1,std::memory_order_acq_rel)!=1) return;
+            ready.swap(c.waiting);
+        }
+        for(Job& r : ready) push(std::move(r));
+    }
+
+    // sem trabalho, dorme; o timeout cobre o notify que chega entre o
+    // teste e o wait
+    void workerLoop(int index){
+        jobOwner = this;
+        jobIndex = index;
+        while(!quit){
+            Job j;
+            if(pop(j)){ execute(j); continue; }
+            std::unique_lock<std::mutex> lk(sleepM);
+            wake.wait_for(lk,std::chrono::milliseconds(1),[this]{ return quit || queued.load()>0; });
+        }
+    }
+};
+
+// sistema do processo, uma thread por núcleo
+inline JobSystem& jobSystem(){
+    static JobSystem js;
+    return js;
+}
@@ -0,0 +1,158 @@
+// MultiTexBatch.h
+// Lote que não quebra na troca de textura: até N texturas ficam ligadas ao
+// mesmo tempo (N = GL_MAX_TEXTURE_IMAGE_UNITS, limitado a
+// MULTI_TEX_MAX_SLOTS) e cada vértice leva o índice da sua unidade. O GLSL
+// 3.30 só indexa array de sampler com constante, então o fragment shader
+// é gerado com um if por unidade; as derivadas saem antes dos ifs
+// (textureGrad), porque o índice pode variar entre fragmentos vizinhos.
+// O lote só quebra quando aparece mais textura do que unidade, e fundo,
+// personagens e NPCs de folhas diferentes saem na ordem do pintor num draw.
+
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "FrameUniforms.h"
+#include "ProgramBatch.h"
+#include "ProgramCache.h"
+#include "SpriteSheet.h"
+#include "StreamBuffer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+const int MULTI_TEX_MAX_SLOTS = 16;
+
+struct MultiTexVertex {
+    float    x, y, u, v;
+    uint32_t slot;          // unidade de textura do sprite
+};
+
+const char* const MULTI_TEX_VS = R"glsl(
+layout(location=0) in vec2 aPos;
+layout(location=1) in vec2 aUV;
+layout(location=2) in uint aSlot;
+out vec2 UV;
+flat out uint vSlot;
+void main(){
+    UV = aUV;
+    vSlot = aSlot;
+    gl_Position = projection * view * vec4(aPos,0,1);
+}
+)glsl";
+
+// fragment shader com um ramo por unidade
+inline std::string multiTexFS(int slots){
+    std::string s = "in vec2 UV;\nflat in uint vSlot;\nout vec4 Frag;\n";
+    s += "uniform sampler2D tex[" + std::to_string(slots) + "];\n";
+    s += "void main(){\n    vec2 dx = dFdx(UV), dy = dFdy(UV);\n    vec4 c;\n";
+    for(int i=0;i<slots;++i){
+        std::string n = std::to_string(i);
+        s += slots==1 ? "   " : i==0 ? "    if" : i<slots-1 ? "    else if" : "    else";
+        if(i<slots-1) s += "(vSlot==" + n + "u)";
+        s += " c = textureGrad(tex[" + n + "], UV, dx, dy);\n";
+    }
+    s += "    Frag = c;\n}\n";
+    return s;
+}
+
+struct MultiTexBatch {
+    StreamBuffer stream;
+    std::vector<MultiTexVertex> verts;
+    std::vector<GLuint> textures;       // textura de cada unidade no lote atual
+    GlVertexArray vao;
+    GlProgram     program;
+    int    slots = 0;
+    bool   bound = false;               // sampler e bloco Frame ligados no primeiro flush
+    int    layoutGen = -1;
+    int    draws = 0, sprites = 0;      // do frame corrente
+
+    // com batch, o programa entra no lote de compilação da demo
+    void init(ProgramBatch* batch = nullptr,size_t segmentBytes = 1024*1024){
+        GLint units = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS,&units);
+        slots = std::max(1,std::min(units,MULTI_TEX_MAX_SLOTS));
+        fs = multiTexFS(slots);
+        program = batch ? batch->submit(frameStages(MULTI_TEX_VS,fs.c_str()))
+                        : buildProgram(frameStages(MULTI_TEX_VS,fs.c_str()));
+        vao = GlVertexArray::create();
+        stream.init(segmentBytes);
+    }
+
+    void begin(){
+        draws = sprites = 0;
+        textures.clear();
+        verts.clear();
+    }
+
+    // quad do recorte do frame, como em SpriteBatch::draw
+    void draw(GLuint tex,const SheetFrame& f,glm::vec2 pos,glm::vec2 scale){
+        if(f.empty()) return;
+        uint32_t s = slotFor(tex);
+        glm::vec2 c = pos + f.offset*scale, h = f.size*scale*0.5f;
+        float x0 = c.x-h.x, y0 = c.y-h.y, x1 = c.x+h.x, y1 = c.y+h.y;
+        verts.push_back({x0,y0,f.uv.x,f.uv.y,s}); verts.push_back({x1,y0,f.uv.z,f.uv.y,s}); verts.push_back({x1,y1,f.uv.z,f.uv.w,s});
+        verts.push_back({x0,y0,f.uv.x,f.uv.y,s}); verts.push_back({x1,y1,f.uv.z,f.uv.w,s}); verts.push_back({x0,y1,f.uv.x,f.uv.w,s});
+        ++sprites;
+    }
+
+    // liga as unidades do lote e desenha tudo num draw
+    void flush(){
+        if(verts.empty()){ textures.clear(); return; }
+        size_t at = stream.write(verts.data(),verts.size()*sizeof(MultiTexVertex),sizeof(MultiTexVertex));
+        if(layoutGen != stream.generation) bindLayout();
+        glUseProgram(program);
+        if(!bound){
+            bindFrameBlock(program);
+            std::vector<GLint> units(slots);
+            for(int i=0;i<slots;++i) units[i] = i;
+            glUniform1iv(glGetUniformLocation(program,"tex"),slots,units.data());
+            bound = true;
+        }
+        for(size_t i=0;i<textures.size();++i){
+            glActiveTexture(GL_TEXTURE0 + (GLenum)i);
+            glBindTexture(GL_TEXTURE_2D,textures[i]);
+        }
+        glActiveTexture(GL_TEXTURE0);
+        glBindVertexArray(vao);
+        glDrawArrays(GL_TRIANGLES,(GLint)(at/sizeof(MultiTexVertex)),(GLsizei)verts.size());
+        glBindVertexArray(0);
+        ++draws;
+        verts.clear();
+        textures.clear();
+    }
+
+    void end(){
+        flush();
+        stream.endFrame();
+    }
+
+private:
+    std::string fs;
+
+    // unidade já usada pela textura, uma nova, ou flush se acabaram
+    uint32_t slotFor(GLuint tex){
+        for(size_t i=0;i<textures.size();++i)
+            if(textures[i]==tex) return (uint32_t)i;
+        if((int)textures.size()==slots) flush();
+        textures.push_back(tex);
+        return (uint32_t)textures.size()-1;
+    }
+
+    void bindLayout(){
+        const GLsizei S = sizeof(MultiTexVertex);
+        glBindVertexArray(vao);
+          glBindBuffer(GL_ARRAY_BUFFER,stream.buffer);
+          glEnableVertexAttribArray(0);
+          glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,S,(void*)0);
+          glEnableVertexAttribArray(1);
+          glVertexAttribPointer(1,2,GL_FLOAT,GL_FALSE,S,(void*)(2*sizeof(float)));
+          glEnableVertexAttribArray(2);
+          glVertexAttribIPointer(2,1,GL_UNSIGNED_INT,S,(void*)(4*sizeof(float)));
+        glBindVertexArray(0);
+        layoutGen = stream.generation;
+    }
+};
@@ -0,0 +1,192 @@
+// ProgramBatch.h
+// Compilação dos programas em lote, sobreposta à carga dos assets. Todos
+// os programas são submetidos logo depois de criar o contexto; submit()
+// devolve o programa (GlProgram) na hora, mas ele só pode ser usado
+// depois de finish().
+//   - KHR/ARB_parallel_shader_compile: compila e linka sem consultar
+//     status; o driver trabalha nas threads dele e finish() pergunta;
+//   - sem a extensão: um contexto oculto compartilhado com a janela, numa
+//     thread própria, compila e linka enquanto a thread principal carrega;
+//   - sem contexto extra: compila em série dentro do submit().
+// Acertos no cache de binários (ProgramCache.h) são resolvidos no submit.
+// print() informa quanto do tempo de compilação ficou escondido atrás da carga.
+
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "ProgramCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class CompileMode { Serial, Parallel, Worker };
+
+inline const char* compileModeName(CompileMode m){
+    return m==CompileMode::Parallel ? "paralela no driver"
+         : m==CompileMode::Worker   ? "contexto auxiliar" : "serial";
+}
+
+struct ProgramBatch {
+    using clock = std::chrono::steady_clock;
+
+    CompileMode mode = CompileMode::Serial;
+    int    submitted = 0;
+    double submitMs = 0, waitMs = 0, wallMs = 0, overlappedMs = 0;
+
+    // main = janela com o contexto atual (ainda com os hints da criação)
+    explicit ProgramBatch(GLFWwindow* main){
+        if(GLAD_GL_KHR_parallel_shader_compile && glMaxShaderCompilerThreadsKHR){
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);    // quantas o driver quiser
+            mode = CompileMode::Parallel;
+        } else if(GLAD_GL_ARB_parallel_shader_compile && glMaxShaderCompilerThreadsARB){
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+            mode = CompileMode::Parallel;
+        } else if(main){
+            glfwWindowHint(GLFW_VISIBLE,GLFW_FALSE);
+            worker = glfwCreateWindow(1,1,"",nullptr,main);
+            glfwWindowHint(GLFW_VISIBLE,GLFW_TRUE);
+            glfwMakeContextCurrent(main);
+            if(worker){
+                mode = CompileMode::Worker;
+                thread = std::thread([this]{ workerLoop(); });
+            }
+        }
+    }
+
+    ~ProgramBatch(){ finish(); }
+
+    GlProgram submit(const std::vector<ShaderStage>& stages){
+        auto t0 = clock::now();
+        if(!submitted) first = t0;
+        ++submitted;
+
+        GlProgram p;
+        if(mode==CompileMode::Serial) p = buildProgram(stages);
+        else {
+            p = GlProgram::create();
+            std::unique_ptr<Job> job(new Job);
+            job->program = p;
+            job->binary  = programBinarySupported();
+            job->key     = job->binary ? programKey(stages) : 0;
+            if(job->binary && loadProgramBinary(p,job->key)){
+                ++programCacheStats().cached;
+                programCacheStats().cacheMs += ms(t0);
+            } else {
+                for(const ShaderStage& s : stages){
+                    std::string src;
+                    for(const char* part : s.src) src += part;
+                    job->stages.push_back({s.type,std::move(src)});
+                }
+                if(mode==CompileMode::Parallel){
+                    job->shaders = compileAndLink(p,job->sources(),job->binary);
+                    job->ms = ms(t0);
+                    jobs.push_back(std::move(job));
+                } else {
+                    std::lock_guard<std::mutex> lk(mtx);
+                    queue.push_back(job.get());
+                    jobs.push_back(std::move(job));
+                    cv.notify_one();
+                }
+            }
+        }
+        submitMs += ms(t0);
+        return p;
+    }
+
+    GlProgram submit(const char* vs,const char* fs){
+        return submit({ {GL_VERTEX_SHADER,{vs}}, {GL_FRAGMENT_SHADER,{fs}} });
+    }
+
+    // espera tudo terminar; depois disso os programas podem ser usados
+    void finish(){
+        if(done) return;
+        done = true;
+        auto t0 = clock::now();
+        if(mode==CompileMode::Worker){
+            { std::lock_guard<std::mutex> lk(mtx); closed = true; }
+            cv.notify_one();
+            thread.join();
+            glfwDestroyWindow(worker);
+            worker = nullptr;
+        } else if(mode==CompileMode::Parallel){
+            for(auto& j : jobs){
+                auto tj = clock::now();
+                finishLink(j->program,j->shaders,j->key,j->binary);
+                j->ms += ms(tj);
+            }
+        }
+        ProgramCacheStats& st = programCacheStats();
+        for(auto& j : jobs){ ++st.compiled; st.compileMs += j->ms; }
+        waitMs = ms(t0);
+        if(submitted){
+            wallMs = ms(first);
+            overlappedMs = std::max(0.0, wallMs - submitMs - waitMs);
+        }
+    }
+
+    void print() const {
+        std::printf("[shader] %d programas, compilação %s: %.2f ms submetendo, %.2f ms esperando, "
+                    "%.2f ms sobrepostos com a carga\n",
+                    submitted, compileModeName(mode), submitMs, waitMs, overlappedMs);
+    }
+
+private:
+    struct Job {
+        GLuint   program = 0;
+        uint64_t key = 0;
+        bool     binary = false;
+        double   ms = 0;                                      // tempo de compilação atribuído
+        std::vector<std::pair<GLenum,std::string>> stages;    // cópia das fontes
+        std::vector<GLuint> shaders;
+
+        std::vector<ShaderStage> sources() const {
+            std::vector<ShaderStage> v;
+            for(const auto& s : stages) v.push_back({s.first,{s.second.c_str()}});
+            return v;
+        }
+    };
+
+    std::vector<std::unique_ptr<Job>> jobs;
+    clock::time_point first;
+    bool done = false;
+
+    // contexto auxiliar
+    GLFWwindow*             worker = nullptr;
+    std::thread             thread;
+    std::mutex              mtx;
+    std::condition_variable cv;
+    std::deque<Job*>        queue;
+    bool                    closed = false;
+
+    static double ms(clock::time_point t0){
+        return std::chrono::duration<double,std::milli>(clock::now()-t0).count();
+    }
+
+    void workerLoop(){
+        glfwMakeContextCurrent(worker);
+        for(;;){
+            Job* j;
+            {
+                std::unique_lock<std::mutex> lk(mtx);
+                cv.wait(lk,[&]{ return closed || !queue.empty(); });
+                if(queue.empty()) break;
+                j = queue.front(); queue.pop_front();
+            }
+            auto t0 = clock::now();
+            finishLink(j->program,compileAndLink(j->program,j->sources(),j->binary),j->key,j->binary);
+            j->ms = ms(t0);
+        }
+        glFinish();     // tudo visível para o contexto principal
+        glfwMakeContextCurrent(nullptr);
+    }
+};
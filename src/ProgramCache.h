@@ -0,0 +1,218 @@
+// ProgramCache.h
+// Compilação de programas GLSL com cache em disco dos binários do driver
+// (glGetProgramBinary / glProgramBinary, ARB_get_program_binary). A chave
+// é um FNV-1a das fontes de todos os estágios mais vendor, renderer e
+// versão do GL: trocar uma linha de shader ou atualizar o driver gera outra
+// chave, e o binário antigo simplesmente deixa de ser lido. Se o driver
+// recusar um binário (glProgramBinary sem LINK_STATUS), o arquivo é
+// apagado e o programa volta a ser compilado da fonte.
+//
+// Os arquivos ficam em shader_cache/<chave>.bin, ao lado de resources/.
+// programCacheStats() separa o tempo gasto compilando do gasto lendo cache.
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include "GlHandle.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+const char* const PROGRAM_CACHE_DIR = "shader_cache";
+
+// um estágio do programa; a fonte pode vir em partes (ex.: prelúdio + corpo)
+struct ShaderStage {
+    GLenum                   type;
+    std::vector<const char*> src;
+};
+
+struct ProgramCacheStats {
+    int    compiled = 0, cached = 0, rejected = 0;
+    double compileMs = 0, cacheMs = 0;
+};
+
+inline ProgramCacheStats& programCacheStats(){
+    static ProgramCacheStats s;
+    return s;
+}
+
+inline void printProgramCacheStats(){
+    const ProgramCacheStats& s = programCacheStats();
+    std::printf("[shader] %d compilados em %.2f ms, %d lidos do cache em %.2f ms",
+                s.compiled, s.compileMs, s.cached, s.cacheMs);
+    if(s.rejected) std::printf(", %d binários recusados", s.rejected);
+    std::printf("\n");
+}
+
+inline bool programBinarySupported(){
+    static int ok = -1;
+    if(ok<0){
+        GLint n = 0;
+        if(GLAD_GL_ARB_get_program_binary && glProgramBinary && glGetProgramBinary && glProgramParameteri)
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS,&n);
+        ok = n>0;
+    }
+    return ok==1;
+}
+
+inline uint64_t programKey(const std::vector<ShaderStage>& stages){
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&](const void* p,size_t n){
+        const unsigned char* b = (const unsigned char*)p;
+        for(size_t i=0;i<n;++i){ h ^= b[i]; h *= 1099511628211ull; }
+    };
+    auto mixStr = [&](const char* s){ if(s) mix(s,std::strlen(s)+1); };
+    mixStr((const char*)glGetString(GL_VENDOR));
+    mixStr((const char*)glGetString(GL_RENDERER));
+    mixStr((const char*)glGetString(GL_VERSION));
+    for(const ShaderStage& st : stages){
+        mix(&st.type,sizeof st.type);
+        for(const char* part : st.src) mixStr(part);
+    }
+    return h;
+}
+
+inline std::string programCachePath(uint64_t key){
+    char name[32];
+    std::snprintf(name,sizeof name,"%016llx.bin",(unsigned long long)key);
+    return std::string(PROGRAM_CACHE_DIR) + "/" + name;
+}
+
+// cabeçalho do arquivo de cache
+struct ProgramBinaryHeader {
+    char     magic[4];      // "GLPB"
+    uint32_t version;
+    uint64_t key;
+    uint32_t format, length;
+};
+const uint32_t PROGRAM_BINARY_VERSION = 1;
+
+inline bool loadProgramBinary(GLuint p,uint64_t key){
+    std::string path = programCachePath(key);
+    std::ifstream in(path,std::ios::binary);
+    if(!in) return false;
+    ProgramBinaryHeader hd;
+    std::vector<char> data;
+    bool valid = in.read((char*)&hd,sizeof hd)
+              && std::memcmp(hd.magic,"GLPB",4)==0 && hd.version==PROGRAM_BINARY_VERSION && hd.key==key;
+    if(valid){
+        data.resize(hd.length);
+        valid = (bool)in.read(data.data(),hd.length);
+    }
+    in.close();
+    GLint ok = 0;
+    if(valid){
+        glProgramBinary(p,hd.format,data.data(),(GLsizei)hd.length);
+        glGetProgramiv(p,GL_LINK_STATUS,&ok);
+    }
+    if(!ok){
+        ++programCacheStats().rejected;
+        std::error_code ec;
+        std::filesystem::remove(path,ec);
+    }
+    return ok!=0;
+}
+
+inline void saveProgramBinary(GLuint p,uint64_t key){
+    GLint len = 0;
+    glGetProgramiv(p,GL_PROGRAM_BINARY_LENGTH,&len);
+    if(len<=0) return;
+    std::vector<char> data(len);
+    ProgramBinaryHeader hd;
+    std::memcpy(hd.magic,"GLPB",4);
+    hd.version = PROGRAM_BINARY_VERSION;
+    hd.key     = key;
+    GLenum fmt = 0;
+    glGetProgramBinary(p,len,nullptr,&fmt,data.data());
+    hd.format  = fmt;
+    hd.length  = (uint32_t)len;
+
+    std::error_code ec;
+    std::filesystem::create_directories(PROGRAM_CACHE_DIR,ec);
+    std::string path = programCachePath(key), tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp,std::ios::binary);
+        if(!out) return;
+        out.write((const char*)&hd,sizeof hd);
+        out.write(data.data(),len);
+        if(!out) return;
+    }
+    std::filesystem::rename(tmp,path,ec);   // nunca deixa arquivo pela metade
+}
+
+inline GLuint compileStage(const ShaderStage& st){
+    GLuint s = glCreateShader(st.type);
+    glShaderSource(s,(GLsizei)st.src.size(),st.src.data(),nullptr);
+    glCompileShader(s);
+    return s;
+}
+
+inline const char* stageName(GLenum t){
+    return t==GL_VERTEX_SHADER ? "VS" : t==GL_FRAGMENT_SHADER ? "FS" : "GS";
+}
+
+// compila e linka sem consultar status nenhum: com KHR_parallel_shader_compile
+// o driver segue em outras threads até alguém perguntar pelo resultado
+inline std::vector<GLuint> compileAndLink(GLuint p,const std::vector<ShaderStage>& stages,bool retrievable){
+    std::vector<GLuint> sh;
+    for(const ShaderStage& s : stages){
+        sh.push_back(compileStage(s));
+        glAttachShader(p,sh.back());
+    }
+    if(retrievable) glProgramParameteri(p,GL_PROGRAM_BINARY_RETRIEVABLE_HINT,GL_TRUE);
+    glLinkProgram(p);
+    return sh;
+}
+
+// espera o link, mostra os logs de erro, solta os shaders e guarda o binário
+inline bool finishLink(GLuint p,const std::vector<GLuint>& sh,uint64_t key,bool binary){
+    GLint ok; char log[512];
+    glGetProgramiv(p,GL_LINK_STATUS,&ok);
+    if(!ok){
+        for(GLuint s : sh){
+            GLint c; glGetShaderiv(s,GL_COMPILE_STATUS,&c);
+            if(c) continue;
+            GLint t; glGetShaderiv(s,GL_SHADER_TYPE,&t);
+            glGetShaderInfoLog(s,512,nullptr,log);
+            std::cerr<<stageName((GLenum)t)<<" error:\n"<<log;
+        }
+        glGetProgramInfoLog(p,512,nullptr,log);
+        std::cerr<<"Link error:\n"<<log;
+    }
+    for(GLuint s : sh){ glDetachShader(p,s); glDeleteShader(s); }
+    if(ok && binary) saveProgramBinary(p,key);
+    return ok!=0;
+}
+
+// programa pronto: do cache quando possível, senão compilado e guardado
+inline GlProgram buildProgram(const std::vector<ShaderStage>& stages){
+    using clock = std::chrono::steady_clock;
+    auto t0 = clock::now();
+    ProgramCacheStats& st = programCacheStats();
+    GlProgram p = GlProgram::create();
+
+    bool binary = programBinarySupported();
+    uint64_t key = binary ? programKey(stages) : 0;
+    if(binary && loadProgramBinary(p,key)){
+        ++st.cached;
+        st.cacheMs += std::chrono::duration<double,std::milli>(clock::now()-t0).count();
+        return p;
+    }
+    finishLink(p,compileAndLink(p,stages,binary),key,binary);
+
+    ++st.compiled;
+    st.compileMs += std::chrono::duration<double,std::milli>(clock::now()-t0).count();
+    return p;
+}
+
+inline GlProgram buildProgram(const char* vs,const char* fs){
+    return buildProgram({ {GL_VERTEX_SHADER,{vs}}, {GL_FRAGMENT_SHADER,{fs}} });
+}
@@ -0,0 +1,101 @@
+// RenderPasses.h
+// Separação opaco / recorte / translúcido. Na carga cada frame é
+// classificado pelo alfa dos seus texels; no desenho:
+//   1. passe opaco: teste e escrita de profundidade, sem blend, da frente
+//      para trás; texels que não são totalmente opacos são descartados
+//      (em frames "recorte", o limiar é 0.5 e nada sobra para o passe 2);
+//   2. passe translúcido: só os frames com texels de alfa intermediário,
+//      de trás para frente, com blend, testando (sem escrever) profundidade
+//      e descartando o que já saiu no passe 1.
+// Assim cada pixel coberto por algo opaco é sombreado uma vez só, e o
+// blend fica restrito às bordas realmente translúcidas.
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include "Image.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+enum class AlphaClass : uint8_t {
+    Opaque,         // todo texel com alfa 255
+    Cutout,         // só 0 e 255
+    Translucent     // tem alfa intermediário
+};
+
+inline const char* alphaClassName(AlphaClass c){
+    return c==AlphaClass::Opaque ? "opaco" : c==AlphaClass::Cutout ? "recorte" : "translúcido";
+}
+
+// classifica a região (x0,y0,w,h) da imagem
+inline AlphaClass classifyAlpha(const Image& img,int x0,int y0,int w,int h){
+    bool any0 = false;
+    for(int y=0;y<h;++y){
+        const unsigned char* r = img.row(y0+y) + x0*4;
+        for(int x=0;x<w;++x){
+            unsigned char a = r[x*4+3];
+            if(a!=0 && a!=255) return AlphaClass::Translucent;
+            any0 |= (a==0);
+        }
+    }
+    return any0 ? AlphaClass::Cutout : AlphaClass::Opaque;
+}
+
+// faixa de alfa mantida pelo shader (fora dela: discard)
+struct AlphaCut { float lo, hi; };
+
+const float ALPHA_EPS = 0.5f/255.0f;
+const AlphaCut CUT_NONE         = { -1.0f,           2.0f };              // opaco: não descarta nada
+const AlphaCut CUT_OPAQUE_TEXEL = { 1.0f-ALPHA_EPS,  2.0f };              // só texels totalmente opacos
+const AlphaCut CUT_HALF         = { 0.5f,            2.0f };              // recorte clássico
+const AlphaCut CUT_TRANSLUCENT  = { ALPHA_EPS,       1.0f-ALPHA_EPS };    // só as bordas
+
+// faixa do passe opaco para cada classe
+inline AlphaCut opaqueCut(AlphaClass c){
+    return c==AlphaClass::Opaque ? CUT_NONE : c==AlphaClass::Cutout ? CUT_HALF : CUT_OPAQUE_TEXEL;
+}
+
+// ——————————————————————
+// Estado de cada passe
+
+inline void beginOpaquePass(){
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+}
+
+inline void beginTranslucentPass(){
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LEQUAL);
+    glDepthMask(GL_FALSE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
+}
+
+// volta ao estado das demos (sem profundidade, com blend)
+inline void endPasses(){
+    glDepthMask(GL_TRUE);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
+}
+
+// ——————————————————————
+// Ordenação dos itens de cada passe (z maior = mais perto, como na ortho(-1,1))
+
+struct PassItem {
+    float z;
+    int   index;    // índice no vetor de objetos do chamador
+};
+
+inline void sortFrontToBack(std::vector<PassItem>& v){
+    std::sort(v.begin(),v.end(),[](const PassItem& a,const PassItem& b){ return a.z > b.z; });
+}
+
+inline void sortBackToFront(std::vector<PassItem>& v){
+    std::sort(v.begin(),v.end(),[](const PassItem& a,const PassItem& b){ return a.z < b.z; });
+}
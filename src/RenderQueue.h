@@ -0,0 +1,191 @@
+// RenderQueue.h
+// Fila de desenho com chave de ordenação de 64 bits. Cada submissão leva
+// uma chave (passe, camada, shader, textura, profundidade) e a fila é
+// ordenada por radix sort (LSD, 8 bits por passada, estável) antes de ir
+// para o GL. A ordem fica determinística, independente da ordem do código,
+// e trocas de programa/textura só acontecem quando a chave muda.
+//
+// Layout da chave (bit 63 à esquerda):
+//   opaco:       passe(2)=0 | 255-camada(8) | shader(8) | textura(16) | prof.(24, perto primeiro) | 0(6)
+//   translúcido: passe(2)=1 | camada(8)     | prof.(24, longe primeiro) | shader(8) | textura(16) | 0(6)
+// No passe opaco o depth buffer resolve a visibilidade, então a ordem serve
+// só para agrupar estado e aproveitar o early-z; no translúcido a ordem é a
+// do pintor. Shader e textura entram pelos bits baixos do nome GL: colisões
+// só pioram o agrupamento, nunca a correção.
+
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "RenderPasses.h"
+#include "SpriteSheet.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+struct SortItem {
+    uint64_t key;
+    uint32_t index;
+};
+
+// radix sort LSD estável; passadas em que todas as chaves têm o mesmo byte são puladas
+inline void radixSort(std::vector<SortItem>& v,std::vector<SortItem>& tmp){
+    size_t n = v.size();
+    if(n<2) return;
+    tmp.resize(n);
+    size_t count[8][256];
+    std::memset(count,0,sizeof count);
+    for(const SortItem& it : v)
+        for(int b=0;b<8;++b) ++count[b][(it.key >> (8*b)) & 0xFF];
+
+    SortItem* src = v.data();
+    SortItem* dst = tmp.data();
+    for(int b=0;b<8;++b){
+        size_t* c = count[b];
+        if(c[(src[0].key >> (8*b)) & 0xFF] == n) continue;   // byte constante
+        size_t sum = 0;
+        for(int i=0;i<256;++i){ size_t t = c[i]; c[i] = sum; sum += t; }
+        for(size_t i=0;i<n;++i) dst[c[(src[i].key >> (8*b)) & 0xFF]++] = src[i];
+        std::swap(src,dst);
+    }
+    if(src != v.data()) std::memcpy(v.data(),src,n*sizeof(SortItem));
+}
+
+namespace SortKey {
+    enum Pass : uint64_t { OPAQUE = 0, TRANSLUCENT = 1 };
+
+    // z em [-1,1] (maior = mais perto) -> 24 bits, 0 = mais perto
+    inline uint64_t depth24(float z){
+        float t = (1.0f - std::min(1.0f, std::max(-1.0f, z))) * 0.5f;
+        return (uint64_t)(t * 16777215.0f);
+    }
+
+    inline uint64_t opaque(uint8_t layer,GLuint shader,GLuint tex,float z){
+        return  (uint64_t)OPAQUE             << 62
+             | (uint64_t)(255-layer)         << 54
+             | (uint64_t)(shader & 0xFF)     << 46
+             | (uint64_t)(tex & 0xFFFF)      << 30
+             | depth24(z)                    << 6;
+    }
+
+    inline uint64_t translucent(uint8_t layer,GLuint shader,GLuint tex,float z){
+        return  (uint64_t)TRANSLUCENT        << 62
+             | (uint64_t)layer               << 54
+             | (0xFFFFFFull - depth24(z))    << 30
+             | (uint64_t)(shader & 0xFF)     << 22
+             | (uint64_t)(tex & 0xFFFF)      << 6;
+    }
+
+    inline Pass pass(uint64_t key){ return (Pass)(key >> 62); }
+}
+
+// um desenho de sprite: quad/malha (vao, first, count) com o modelo
+// translate(pos) * scale(size) e o retângulo de UV no atlas
+struct DrawCmd {
+    GLuint    program = 0, tex = 0, vao = 0;
+    int       first = 0, count = 6;
+    glm::vec3 pos{0,0,0};
+    glm::vec2 size{1,1};
+    glm::vec4 uv{0,0,1,1};
+    AlphaCut  cut = CUT_NONE;
+};
+
+struct QueueStats {
+    int    draws = 0, programBinds = 0, textureBinds = 0, vaoBinds = 0;
+    double sortMs = 0;
+
+    int stateChanges() const { return programBinds + textureBinds + vaoBinds; }
+};
+
+struct RenderQueue {
+    std::vector<DrawCmd>  cmds;
+    std::vector<SortItem> items, tmp;
+    QueueStats            stats;
+
+    void clear(){ cmds.clear(); items.clear(); }
+
+    void submit(uint64_t key,const DrawCmd& c){
+        items.push_back({key,(uint32_t)cmds.size()});
+        cmds.push_back(c);
+    }
+
+    void sort(){
+        auto t0 = std::chrono::steady_clock::now();
+        radixSort(items,tmp);
+        stats.sortMs = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-t0).count();
+    }
+
+    // envia na ordem das chaves, trocando estado só quando muda
+    void execute(){
+        QueueStats s; s.sortMs = stats.sortMs;
+        GLuint prog = 0, tex = 0, vao = 0;
+        int pass = -1;
+        const Locs* L = nullptr;
+        for(const SortItem& it : items){
+            const DrawCmd& c = cmds[it.index];
+            int p = (int)SortKey::pass(it.key);
+            if(p != pass){
+                if(p==SortKey::OPAQUE) beginOpaquePass(); else beginTranslucentPass();
+                pass = p;
+            }
+            if(c.program != prog){ glUseProgram(c.program); prog = c.program; L = &locsFor(prog); ++s.programBinds; }
+            if(c.tex != tex)     { glBindTexture(GL_TEXTURE_2D,c.tex); tex = c.tex; ++s.textureBinds; }
+            if(c.vao != vao)     { glBindVertexArray(c.vao); vao = c.vao; ++s.vaoBinds; }
+
+            glm::mat4 M = glm::translate(glm::mat4(1.0f), c.pos)
+                        * glm::scale   (glm::mat4(1.0f), glm::vec3(c.size,1.0f));
+            glUniformMatrix4fv(L->model,1,GL_FALSE,glm::value_ptr(M));
+            glUniform2f(L->texScale, c.uv.z-c.uv.x, c.uv.w-c.uv.y);
+            glUniform2f(L->texOffset,c.uv.x, c.uv.y);
+            glUniform2f(L->alphaCut, c.cut.lo, c.cut.hi);
+            glDrawArrays(GL_TRIANGLES,c.first,c.count);
+            ++s.draws;
+        }
+        if(pass>=0) endPasses();
+        stats = s;
+    }
+
+private:
+    struct Locs { GLint model, texScale, texOffset, alphaCut; };
+    std::unordered_map<GLuint,Locs> locs;
+
+    const Locs& locsFor(GLuint prog){
+        auto it = locs.find(prog);
+        if(it!=locs.end()) return it->second;
+        Locs l;
+        l.model     = glGetUniformLocation(prog,"model");
+        l.texScale  = glGetUniformLocation(prog,"texScale");
+        l.texOffset = glGetUniformLocation(prog,"texOffset");
+        l.alphaCut  = glGetUniformLocation(prog,"u_alphaCut");
+        return locs.emplace(prog,l).first->second;
+    }
+};
+
+// submete um frame de spritesheet: sempre no passe opaco e, se tiver alfa
+// intermediário, também no translúcido (mesma malha, faixa de alfa complementar)
+inline void submitSprite(RenderQueue& q,GLuint program,uint8_t layer,const SpriteSheet& sheet,
+                         const SheetFrame& f,glm::vec2 pos,glm::vec2 scale,float z){
+    if(f.empty()) return;
+    DrawCmd c;
+    c.program = program;
+    c.tex     = sheet.tex;
+    c.vao     = sheet.meshVAO;
+    c.first   = f.meshFirst;
+    c.count   = f.meshCount;
+    c.pos     = glm::vec3(pos + f.offset*scale, z);
+    c.size    = f.size*scale;
+    c.uv      = f.uv;
+    c.cut     = opaqueCut(f.alpha);
+    q.submit(SortKey::opaque(layer,program,sheet.tex,z),c);
+    if(f.alpha==AlphaClass::Translucent){
+        c.cut = CUT_TRANSLUCENT;
+        q.submit(SortKey::translucent(layer,program,sheet.tex,z),c);
+    }
+}
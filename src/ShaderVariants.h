@@ -0,0 +1,176 @@
+// ShaderVariants.h
+// Permutações de um mesmo shader por #define. A fonte é uma só e cada
+// combinação de flags vira um programa próprio, compilado na primeira vez
+// em que é pedido e guardado numa tabela indexada pelas flags. O
+// renderizador escolhe a variante por lote, e o fragment shader não tem
+// mais if de uniform: o que a variante não usa nem é compilado.
+//
+//   OUTLINE        cor sólida (u_outlineColor) na forma do alfa da textura
+//   TINT           multiplica por u_tint
+//   ALPHA_TEST     descarta fora da faixa u_alphaCut (passes opaco/translúcido)
+//   PREMULTIPLIED  saída com alfa pré-multiplicado (blend ONE, 1-SRC_ALPHA)
+//   VERTEX_TINT    multiplica pelo tint que vem do vertex shader (vTint,
+//                  ex.: registros de instância em SpriteInstancing.h)
+//   TEXTURE_ARRAY  spriteTex é um sampler2DArray, camada em vLayer
+//                  (SpriteArray.h; o vertex shader precisa escrever vLayer)
+//
+// Sem ALPHA_TEST não há discard, e o early-z continua valendo.
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include "FrameUniforms.h"
+#include "ProgramBatch.h"
+#include "ProgramCache.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+enum ShaderFlag : uint32_t {
+    SH_OUTLINE       = 1u << 0,
+    SH_TINT          = 1u << 1,
+    SH_ALPHA_TEST    = 1u << 2,
+    SH_PREMULTIPLIED = 1u << 3,
+    SH_VERTEX_TINT   = 1u << 4,
+    SH_TEXTURE_ARRAY = 1u << 5,
+    SH_FLAG_COUNT    = 6
+};
+
+const char* const SHADER_FLAG_NAMES[SH_FLAG_COUNT] = { "OUTLINE", "TINT", "ALPHA_TEST", "PREMULTIPLIED",
+                                                       "VERTEX_TINT", "TEXTURE_ARRAY" };
+
+// shaders de sprite das demos de textura (pos+uv, sub-UV por texScale/texOffset);
+// o vertex shader recebe o bloco Frame (projection, view) de FrameUniforms.h
+const char* const SPRITE_VS = R"glsl(
+layout(location=0) in vec2 aPos;
+layout(location=1) in vec2 aUV;
+uniform mat4 model;
+uniform vec2 texScale;
+uniform vec2 texOffset;
+out vec2 UV;
+void main(){
+    UV = aUV * texScale + texOffset;
+    gl_Position = projection * view * model * vec4(aPos,0,1);
+}
+)glsl";
+
+const char* const SPRITE_FS = R"glsl(
+in vec2 UV;
+out vec4 Frag;
+#ifdef TEXTURE_ARRAY
+uniform sampler2DArray spriteTex;
+flat in float vLayer;
+#else
+uniform sampler2D spriteTex;
+#endif
+#ifdef OUTLINE
+uniform vec4 u_outlineColor;
+#endif
+#ifdef TINT
+uniform vec4 u_tint;
+#endif
+#ifdef ALPHA_TEST
+uniform vec2 u_alphaCut;        // faixa de alfa mantida neste passe
+#endif
+#ifdef VERTEX_TINT
+in vec4 vTint;
+#endif
+void main(){
+#ifdef TEXTURE_ARRAY
+    vec4 c = texture(spriteTex, vec3(UV, vLayer));
+#else
+    vec4 c = texture(spriteTex, UV);
+#endif
+#ifdef ALPHA_TEST
+    if(c.a < u_alphaCut.x || c.a > u_alphaCut.y) discard;
+#endif
+#ifdef OUTLINE
+    c = vec4(u_outlineColor.rgb, u_outlineColor.a * c.a);
+#endif
+#ifdef TINT
+    c *= u_tint;
+#endif
+#ifdef VERTEX_TINT
+    c *= vTint;
+#endif
+#ifdef PREMULTIPLIED
+    c.rgb *= c.a;
+#endif
+    Frag = c;
+}
+)glsl";
+
+// cabeçalho de cada variante: versão + um #define por flag ligada
+inline std::string variantPrelude(uint32_t flags){
+    std::string s = "#version 330 core\n";
+    for(uint32_t i=0;i<SH_FLAG_COUNT;++i)
+        if(flags & (1u<<i)) s += std::string("#define ") + SHADER_FLAG_NAMES[i] + " 1\n";
+    return s;
+}
+
+struct ShaderVariants {
+    static const uint32_t COUNT = 1u << SH_FLAG_COUNT;
+
+    const char* vs;
+    const char* fs;
+    const char* gs;         // opcional; recebe o bloco Frame como o VS
+    std::array<GlProgram,COUNT> programs;     // donos; get() empresta o nome
+    int compiled = 0;       // variantes montadas (da fonte ou do cache)
+
+    ShaderVariants(const char* vsBody = SPRITE_VS,const char* fsBody = SPRITE_FS,const char* gsBody = nullptr)
+      : vs(vsBody), fs(fsBody), gs(gsBody) {}
+
+    // variante com chave conhecida em tempo de compilação
+    template<uint32_t Flags>
+    GLuint get(){
+        static_assert(Flags < COUNT, "flag de shader desconhecida");
+        return get(Flags);
+    }
+
+    GLuint get(uint32_t flags){
+        GlProgram& p = programs[flags & (COUNT-1)];
+        if(!p) p = build(flags);
+        return p;
+    }
+
+    // submete a variante no lote; get() devolve o mesmo nome, utilizável
+    // depois de batch.finish()
+    void request(ProgramBatch& batch,uint32_t flags){
+        GlProgram& p = programs[flags & (COUNT-1)];
+        if(p) return;
+        std::string prelude = variantPrelude(flags);
+        ++compiled;
+        p = batch.submit(stages(prelude,vs,fs,gs));
+    }
+
+    // blend adequado à saída da variante
+    static void blendFor(uint32_t flags){
+        glBlendFunc(flags & SH_PREMULTIPLIED ? GL_ONE : GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+
+    // bloco Frame e sampler iguais para todas as variantes já compiladas
+    void setCommon(int texUnit = 0){
+        for(const GlProgram& p : programs){
+            if(!p) continue;
+            bindFrameBlock(p);
+            glUseProgram(p);
+            glUniform1i(glGetUniformLocation(p,"spriteTex"),texUnit);
+        }
+    }
+
+private:
+    GlProgram build(uint32_t flags){
+        std::string prelude = variantPrelude(flags);
+        ++compiled;
+        return buildProgram(stages(prelude,vs,fs,gs));
+    }
+
+    static std::vector<ShaderStage> stages(const std::string& prelude,const char* vs,const char* fs,const char* gs){
+        std::vector<ShaderStage> st = { {GL_VERTEX_SHADER,  {prelude.c_str(),FRAME_BLOCK_GLSL,vs}},
+                                        {GL_FRAGMENT_SHADER,{prelude.c_str(),fs}} };
+        if(gs) st.push_back({GL_GEOMETRY_SHADER,{prelude.c_str(),FRAME_BLOCK_GLSL,gs}});
+        return st;
+    }
+};
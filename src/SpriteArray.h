@@ -0,0 +1,132 @@
+// SpriteArray.h
+// Folhas de um personagem fatiadas em camadas de um GL_TEXTURE_2D_ARRAY:
+// cada célula vira uma camada com a própria cadeia de mips (downsample2x
+// da célula, Image.h, uma célula por tarefa no JobSystem), então o mip de um frame nunca mistura pixels do
+// vizinho e não precisa de margem entre frames. Um clipe é um intervalo de
+// camadas, e todos os clipes do personagem (idle, walk, run...) saem com
+// um único bind. As células não são recortadas: o quad cobre a célula
+// inteira (ver SpriteSheet.h para o atlas recortado).
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include "Image.h"
+#include "JobSystem.h"
+#include "TextureLoader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// uma folha em grade já no tamanho de tela (células de cellW x cellH)
+struct SheetSlices {
+    const char*  name;
+    const Image* img;
+    int          nRows, nCols;
+};
+
+struct ArrayClip {
+    std::string name;
+    int         firstLayer = 0, count = 0;
+};
+
+struct SpriteArray {
+    GlTexture tex;
+    int    cellW = 0, cellH = 0, layers = 0;
+    std::vector<ArrayClip> clips;       // um por linha de cada folha, na ordem das folhas
+
+    // clipe pelo nome da folha e linha ("walk", 0); -1 se não existe
+    int clip(const char* name,int row = 0) const {
+        for(size_t i=0;i<clips.size();++i)
+            if(clips[i].name==name){
+                int c = (int)i + row;
+                return c < (int)clips.size() && clips[c].name==name ? c : -1;
+            }
+        return -1;
+    }
+};
+
+// cópia da célula (r,c) da folha; a linha 0 da grade fica no topo da imagem
+inline Image sliceCell(const Image& img,int nRows,int r,int c,int cellW,int cellH){
+    Image cell(cellW,cellH);
+    int cx = c*cellW, cy = (nRows-1-r)*cellH;
+    for(int y=0;y<cellH;++y)
+        std::memcpy(cell.row(y), img.row(cy+y) + cx*4, (size_t)cellW*4);
+    return cell;
+}
+
+// todas as folhas devem ter a mesma célula (a da primeira)
+inline SpriteArray uploadSpriteArray(const char* label,const std::vector<SheetSlices>& sheets){
+    using clk = std::chrono::steady_clock;
+    SpriteArray arr;
+    if(sheets.empty()) return arr;
+    arr.cellW = sheets[0].img->w / sheets[0].nCols;
+    arr.cellH = sheets[0].img->h / sheets[0].nRows;
+
+    size_t srcBytes = 0;
+    for(const SheetSlices& s : sheets){
+        if(s.img->w/s.nCols != arr.cellW || s.img->h/s.nRows != arr.cellH){
+            std::fprintf(stderr,"[array] %s: célula %dx%d, esperado %dx%d; folha ignorada\n",
+                         s.name, s.img->w/s.nCols, s.img->h/s.nRows, arr.cellW, arr.cellH);
+            continue;
+        }
+        for(int r=0;r<s.nRows;++r){
+            arr.clips.push_back({s.name,arr.layers,s.nCols});
+            arr.layers += s.nCols;
+        }
+        srcBytes += mipChainBytes(s.img->w,s.img->h);
+    }
+
+    auto t0 = clk::now();
+    int levels = 1;
+    for(int w=arr.cellW,h=arr.cellH; w>1 || h>1; w=std::max(1,w/2), h=std::max(1,h/2)) ++levels;
+
+    arr.tex = GlTexture::create();
+    glBindTexture(GL_TEXTURE_2D_ARRAY,arr.tex);
+    glPixelStorei(GL_UNPACK_ALIGNMENT,1);
+    for(int l=0,w=arr.cellW,h=arr.cellH; l<levels; ++l, w=std::max(1,w/2), h=std::max(1,h/2))
+        glTexImage3D(GL_TEXTURE_2D_ARRAY,l,GL_RGBA8,w,h,arr.layers,0,GL_RGBA,GL_UNSIGNED_BYTE,nullptr);
+
+    // cadeias de mips em paralelo; o envio fica nesta thread (contexto GL)
+    struct Cell { const SheetSlices* s; int r, c; };
+    std::vector<Cell> cells;
+    for(const SheetSlices& s : sheets){
+        if(s.img->w/s.nCols != arr.cellW || s.img->h/s.nRows != arr.cellH) continue;
+        for(int r=0;r<s.nRows;++r)
+            for(int c=0;c<s.nCols;++c) cells.push_back({&s,r,c});
+    }
+    std::vector<std::vector<Image>> mips(cells.size());
+    jobSystem().parallelFor(0,(int)cells.size(),1,[&](int i0,int i1){
+        for(int i=i0;i<i1;++i){
+            const Cell& k = cells[i];
+            mips[i].push_back(sliceCell(*k.s->img,k.s->nRows,k.r,k.c,arr.cellW,arr.cellH));
+            for(int l=1;l<levels;++l) mips[i].push_back(downsample2x(mips[i].back(),1));
+        }
+    });
+    for(size_t layer=0;layer<mips.size();++layer)
+        for(int l=0;l<levels;++l){
+            const Image& m = mips[layer][l];
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY,l,0,0,(GLint)layer,m.w,m.h,1,GL_RGBA,GL_UNSIGNED_BYTE,m.px.data());
+        }
+    glTexParameteri(GL_TEXTURE_2D_ARRAY,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY,GL_TEXTURE_MIN_FILTER,GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D_ARRAY,0);
+
+    TextureStats st;
+    st.path     = label;
+    st.srcW     = sheets[0].img->w;   st.srcH = sheets[0].img->h;
+    st.w        = arr.cellW;          st.h    = arr.cellH*arr.layers;
+    st.srcBytes = srcBytes;
+    st.bytes    = arr.layers*mipChainBytes(arr.cellW,arr.cellH);
+    st.uploadMs = std::chrono::duration<double,std::milli>(clk::now()-t0).count();
+    textureStats().push_back(st);
+    std::printf("[array] %-32s %d camadas de %dx%d, %d clipes, %d mips\n",
+                label, arr.layers, arr.cellW, arr.cellH, (int)arr.clips.size(), levels);
+    return arr;
+}
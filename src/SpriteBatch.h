@@ -0,0 +1,90 @@
+// SpriteBatch.h
+// Sprites expandidos na CPU: cada frame de folha vira 6 vértices pos+uv já
+// em coordenadas de mundo, acumulados enquanto a textura não muda e
+// enviados pelo StreamBuffer num draw por troca de textura. Usa o SPRITE_VS
+// das outras demos com model identidade e sub-UV neutro, então serve
+// qualquer variante de ShaderVariants; uniforms da variante (tint, faixa de
+// alfa) ficam com quem chama, depois de begin().
+
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "SpriteSheet.h"
+#include "StreamBuffer.h"
+
+#include <vector>
+
+struct SpriteVertex {
+    float x, y, u, v;
+};
+
+struct SpriteBatch {
+    StreamBuffer stream;
+    std::vector<SpriteVertex> verts;
+    GlVertexArray vao;
+    GLuint tex = 0, program = 0;        // tex: a do lote atual, sem dono
+    int    layoutGen = -1;
+    int    draws = 0, sprites = 0;     // do frame corrente
+
+    void init(size_t segmentBytes = 1024*1024,StreamMode mode = StreamMode::Persistent){
+        vao = GlVertexArray::create();
+        stream.init(segmentBytes,GL_ARRAY_BUFFER,mode);
+    }
+
+    // programa em uso e uniforms neutros; zera os contadores do frame
+    void begin(GLuint p){
+        program = p;
+        tex = 0;
+        draws = sprites = 0;
+        glUseProgram(p);
+        glm::mat4 I(1.0f);
+        glUniformMatrix4fv(glGetUniformLocation(p,"model"),1,GL_FALSE,glm::value_ptr(I));
+        glUniform2f(glGetUniformLocation(p,"texScale"),1.0f,1.0f);
+        glUniform2f(glGetUniformLocation(p,"texOffset"),0.0f,0.0f);
+    }
+
+    // quad do recorte do frame, centrado em pos com a célula em scale px
+    void draw(GLuint t,const SheetFrame& f,glm::vec2 pos,glm::vec2 scale){
+        if(f.empty()) return;
+        if(t != tex){ flush(); tex = t; }
+        glm::vec2 c = pos + f.offset*scale, h = f.size*scale*0.5f;
+        float x0 = c.x-h.x, y0 = c.y-h.y, x1 = c.x+h.x, y1 = c.y+h.y;
+        verts.push_back({x0,y0,f.uv.x,f.uv.y}); verts.push_back({x1,y0,f.uv.z,f.uv.y}); verts.push_back({x1,y1,f.uv.z,f.uv.w});
+        verts.push_back({x0,y0,f.uv.x,f.uv.y}); verts.push_back({x1,y1,f.uv.z,f.uv.w}); verts.push_back({x0,y1,f.uv.x,f.uv.w});
+        ++sprites;
+    }
+
+    // envia o que acumulou com a textura atual
+    void flush(){
+        if(verts.empty()) return;
+        size_t at = stream.write(verts.data(),verts.size()*sizeof(SpriteVertex),sizeof(SpriteVertex));
+        if(layoutGen != stream.generation) bindLayout();
+        glBindTexture(GL_TEXTURE_2D,tex);
+        glBindVertexArray(vao);
+        glDrawArrays(GL_TRIANGLES,(GLint)(at/sizeof(SpriteVertex)),(GLsizei)verts.size());
+        glBindVertexArray(0);
+        ++draws;
+        verts.clear();
+    }
+
+    // último flush do frame e troca de segmento do stream
+    void end(){
+        flush();
+        stream.endFrame();
+    }
+
+private:
+    void bindLayout(){
+        glBindVertexArray(vao);
+          glBindBuffer(GL_ARRAY_BUFFER,stream.buffer);
+          glEnableVertexAttribArray(0);
+          glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,sizeof(SpriteVertex),(void*)0);
+          glEnableVertexAttribArray(1);
+          glVertexAttribPointer(1,2,GL_FLOAT,GL_FALSE,sizeof(SpriteVertex),(void*)(2*sizeof(float)));
+        glBindVertexArray(0);
+        layoutGen = stream.generation;
+    }
+};
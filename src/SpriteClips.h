@@ -0,0 +1,264 @@
+// SpriteClips.h
+// Animação calculada na GPU. Os clipes (linha de uma folha + fps + loop)
+// ficam numa tabela num uniform buffer, com o retângulo de UV e o
+// recorte de cada frame. Cada instância guarda só o estado inicial:
+// posição e velocidade, tamanho da célula, clipe, instante de início e
+// velocidade de reprodução. O vertex shader tira do tempo do bloco Frame
+// o frame do clipe e a posição (quicando nas bordas do viewport, como o
+// Actor do benchmark), então um frame parado não custa nada na CPU.
+// Só quem muda de estado (play) é reenviado, e antes disso é rebaseado
+// para o instante da troca.
+// Clipes de um SpriteArray (addLayers) usam a célula inteira e guardam a
+// camada de cada frame; com SH_TEXTURE_ARRAY o shader passa vLayer adiante.
+
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "FrameUniforms.h"
+#include "SpriteArray.h"
+#include "SpriteSheet.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+const GLuint CLIP_UBO_BINDING = 1;      // FRAME_UBO_BINDING = 0
+const int    MAX_CLIPS = 64, MAX_CLIP_FRAMES = 256;
+
+// std140: só vec4, sem padding
+struct ClipTableData {
+    glm::vec4 clips[MAX_CLIPS];             // primeiro frame, nº de frames, fps, loop
+    glm::vec4 uv[MAX_CLIP_FRAMES];          // (u0,v0,u1,v1)
+    glm::vec4 rect[MAX_CLIP_FRAMES];        // deslocamento e tamanho do recorte, em fração da célula
+    glm::vec4 layer[MAX_CLIP_FRAMES/4];     // camada no array, 4 frames por vec4
+};
+
+// tamanhos iguais a MAX_CLIPS / MAX_CLIP_FRAMES
+const char* const CLIP_BLOCK_GLSL = R"glsl(
+layout(std140) uniform Clips {
+    vec4 clips[64];
+    vec4 clipUV[256];
+    vec4 clipRect[256];
+    vec4 clipLayer[64];
+};
+)glsl";
+
+struct ClipTable {
+    GlBuffer      ubo;
+    ClipTableData data{};
+    int           clips = 0, frames = 0;
+
+    // linha anim da folha como um clipe; devolve o id (-1 se a tabela encheu)
+    int add(const SpriteSheet& s,int anim,float fps,bool loop = true){
+        if(clips==MAX_CLIPS || frames+s.nCols > MAX_CLIP_FRAMES){
+            std::fprintf(stderr,"[clipes] tabela cheia\n");
+            return -1;
+        }
+        data.clips[clips] = glm::vec4((float)frames,(float)s.nCols,fps,loop ? 1.0f : 0.0f);
+        for(int f=0;f<s.nCols;++f){
+            const SheetFrame& fr = s.frame(anim,f);
+            data.uv[frames]   = fr.uv;
+            data.rect[frames] = glm::vec4(fr.offset.x,fr.offset.y,fr.size.x,fr.size.y);
+            ++frames;
+        }
+        return clips++;
+    }
+
+    // clipe c do array: uma camada por frame, célula inteira
+    int addLayers(const SpriteArray& a,int c,float fps,bool loop = true){
+        if(c<0 || c>=(int)a.clips.size()) return -1;
+        const ArrayClip& ac = a.clips[c];
+        if(clips==MAX_CLIPS || frames+ac.count > MAX_CLIP_FRAMES){
+            std::fprintf(stderr,"[clipes] tabela cheia\n");
+            return -1;
+        }
+        data.clips[clips] = glm::vec4((float)frames,(float)ac.count,fps,loop ? 1.0f : 0.0f);
+        for(int f=0;f<ac.count;++f){
+            data.uv[frames]   = glm::vec4(0,0,1,1);
+            data.rect[frames] = glm::vec4(0,0,1,1);
+            data.layer[frames/4][frames%4] = (float)(ac.firstLayer + f);
+            ++frames;
+        }
+        return clips++;
+    }
+
+    void upload(){
+        if(!ubo) ubo = GlBuffer::create();
+        glBindBuffer(GL_UNIFORM_BUFFER,ubo);
+        glBufferData(GL_UNIFORM_BUFFER,sizeof(ClipTableData),&data,GL_STATIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER,0);
+        glBindBufferBase(GL_UNIFORM_BUFFER,CLIP_UBO_BINDING,ubo);
+    }
+};
+
+inline void bindClipBlock(GLuint program){
+    GLuint idx = glGetUniformBlockIndex(program,"Clips");
+    if(idx != GL_INVALID_INDEX) glUniformBlockBinding(program,idx,CLIP_UBO_BINDING);
+}
+
+struct AnimInstance {
+    float    x, y, vx, vy;          // posição em start e velocidade (px/s)
+    float    w, h, start, rate;     // célula (px), início (s), velocidade de reprodução
+    uint32_t clip;
+    uint32_t tint;                  // RGBA8, R no byte baixo
+};
+static_assert(sizeof(AnimInstance) == 40, "AnimInstance precisa bater com os atributos do ANIMATED_MAIN");
+
+const char* const ANIMATED_MAIN = R"glsl(
+layout(location=0) in vec4 iMotion;
+layout(location=1) in vec4 iCellTime;
+layout(location=2) in uint iClip;
+layout(location=3) in vec4 iTint;
+out vec2 UV;
+out vec4 vTint;
+#ifdef TEXTURE_ARRAY
+flat out float vLayer;
+#endif
+const vec2 CORNER[6] = vec2[](vec2(0,0),vec2(1,0),vec2(1,1),vec2(0,0),vec2(1,1),vec2(0,1));
+// vai e volta entre 0 e hi
+vec2 bounce(vec2 p,vec2 hi){
+    vec2 m = mod(p, 2.0*hi);
+    return mix(m, 2.0*hi - m, step(hi, m));
+}
+void main(){
+    float age = max(u_time.x - iCellTime.z, 0.0);
+    vec4 clip = clips[iClip];
+    int n = int(clip.y);
+    int f = int(age * iCellTime.w * clip.z);
+    f = clip.w > 0.5 ? f % n : min(f, n-1);
+    int k = int(clip.x) + f;
+
+    vec2 c   = CORNER[gl_VertexID];
+    vec2 pos = bounce(iMotion.xy + iMotion.zw*age, u_viewport.zw);
+    vec2 p   = pos + (clipRect[k].xy + (c - 0.5)*clipRect[k].zw) * iCellTime.xy;
+    UV = mix(clipUV[k].xy, clipUV[k].zw, c);
+    vTint = iTint;
+#ifdef TEXTURE_ARRAY
+    vLayer = clipLayer[k >> 2][k & 3];
+#endif
+    gl_Position = projection * view * vec4(p, 0, 1);
+}
+)glsl";
+
+// vertex shader completo, para ShaderVariants(vs) com SH_VERTEX_TINT
+inline const char* animatedVS(){
+    static const std::string s = std::string(CLIP_BLOCK_GLSL) + ANIMATED_MAIN;
+    return s.c_str();
+}
+
+// multidão de instâncias animadas na GPU, agrupadas por textura na ordem do add
+struct AnimatedCrowd {
+    GlVertexArray vao;
+    GlBuffer      vbo;
+    GLuint program = 0;
+    GLenum target = GL_TEXTURE_2D;  // GL_TEXTURE_2D_ARRAY com clipes de SpriteArray
+    std::vector<AnimInstance> items;
+    glm::vec2 bounds{0,0};          // mesmo retângulo que o shader usa (u_viewport.zw)
+    size_t capacity = 0;            // instâncias alocadas no VBO
+    int    uploaded = 0;            // registros enviados no último draw
+    int    draws = 0;
+
+    void init(GLuint prog,glm::vec2 viewport,GLenum texTarget = GL_TEXTURE_2D){
+        program = prog;
+        bounds  = viewport;
+        target  = texTarget;
+        bindClipBlock(program);
+        vao = GlVertexArray::create();
+        vbo = GlBuffer::create();
+        glBindVertexArray(vao);
+          glBindBuffer(GL_ARRAY_BUFFER,vbo);
+          const GLsizei S = sizeof(AnimInstance);
+          glEnableVertexAttribArray(0);
+          glVertexAttribPointer(0,4,GL_FLOAT,GL_FALSE,S,(void*)0);
+          glEnableVertexAttribArray(1);
+          glVertexAttribPointer(1,4,GL_FLOAT,GL_FALSE,S,(void*)16);
+          glEnableVertexAttribArray(2);
+          glVertexAttribIPointer(2,1,GL_UNSIGNED_INT,S,(void*)32);
+          glEnableVertexAttribArray(3);
+          glVertexAttribPointer(3,4,GL_UNSIGNED_BYTE,GL_TRUE,S,(void*)36);
+          for(GLuint i=0;i<4;++i) glVertexAttribDivisor(i,1);
+        glBindVertexArray(0);
+    }
+
+    void clear(){ items.clear(); runs.clear(); dirty.clear(); all = true; }
+
+    int add(GLuint tex,const AnimInstance& a){
+        if(runs.empty() || runs.back().tex != tex) runs.push_back({tex,(int)items.size(),0});
+        items.push_back(a);
+        ++runs.back().count;
+        all = true;
+        return (int)items.size()-1;
+    }
+
+    // troca de estado em now: rebaseia posição/velocidade e reinicia o clipe
+    void play(int i,uint32_t clip,float rate,double now){
+        AnimInstance& a = items[i];
+        float age = (float)std::fmax(now - a.start,0.0);
+        bounce(a.x,a.vx,a.x + a.vx*age,bounds.x);
+        bounce(a.y,a.vy,a.y + a.vy*age,bounds.y);
+        a.clip  = clip;
+        a.rate  = rate;
+        a.start = (float)now;
+        dirty.push_back(i);
+    }
+
+    // envia só o que mudou e desenha um instanciado por textura
+    void draw(){
+        draws = uploaded = 0;
+        if(items.empty()) return;
+        glBindBuffer(GL_ARRAY_BUFFER,vbo);
+        const size_t S = sizeof(AnimInstance);
+        if(items.size() > capacity){
+            capacity = items.size();
+            glBufferData(GL_ARRAY_BUFFER,capacity*S,nullptr,GL_DYNAMIC_DRAW);
+            all = true;
+        }
+        if(all || dirty.size()*4 > items.size()){
+            glBufferSubData(GL_ARRAY_BUFFER,0,items.size()*S,items.data());
+            uploaded = (int)items.size();
+        } else {
+            for(int i : dirty) glBufferSubData(GL_ARRAY_BUFFER,i*S,S,&items[i]);
+            uploaded = (int)dirty.size();
+        }
+        all = false;
+        dirty.clear();
+
+        glUseProgram(program);
+        glBindVertexArray(vao);
+        for(const Run& r : runs){
+            glBindTexture(target,r.tex);
+            pointAttributes(r.first*S);
+            glDrawArraysInstanced(GL_TRIANGLES,0,6,r.count);
+            ++draws;
+        }
+        glBindVertexArray(0);
+    }
+
+private:
+    struct Run { GLuint tex; int first, count; };
+    std::vector<Run> runs;
+    std::vector<int> dirty;
+    bool all = true;
+
+    // mesma conta do bounce() do shader, devolvendo também o sentido
+    static void bounce(float& p,float& v,float x,float hi){
+        if(hi<=0){ p = x; return; }
+        float m = std::fmod(x,2*hi);
+        if(m<0) m += 2*hi;
+        if(m>=hi){ p = 2*hi - m; v = -v; }
+        else       p = m;
+    }
+
+    // sem base instance no 3.3: cada trecho reaponta os atributos (VBO ligado)
+    void pointAttributes(size_t at){
+        const GLsizei S = sizeof(AnimInstance);
+        glVertexAttribPointer(0,4,GL_FLOAT,GL_FALSE,S,(void*)(at));
+        glVertexAttribPointer(1,4,GL_FLOAT,GL_FALSE,S,(void*)(at + 16));
+        glVertexAttribIPointer(2,1,GL_UNSIGNED_INT,S,(void*)(at + 32));
+        glVertexAttribPointer(3,4,GL_UNSIGNED_BYTE,GL_TRUE,S,(void*)(at + 36));
+    }
+};
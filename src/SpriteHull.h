@@ -0,0 +1,105 @@
+// SpriteHull.h
+// Malha justa para cada frame: casco convexo dos texels com alfa, reduzido
+// a no máximo N vértices sem nunca cortar texel visível (cada remoção de
+// aresta estende as vizinhas até se cruzarem, escolhendo a que menos
+// acrescenta área). Coordenadas no espaço do recorte do frame, [0,1]².
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+inline float cross2(glm::vec2 o,glm::vec2 a,glm::vec2 b){
+    return (a.x-o.x)*(b.y-o.y) - (a.y-o.y)*(b.x-o.x);
+}
+
+inline float polygonArea(const std::vector<glm::vec2>& p){
+    float a = 0;
+    for(size_t i=0;i<p.size();++i){
+        const glm::vec2& u = p[i];
+        const glm::vec2& v = p[(i+1)%p.size()];
+        a += u.x*v.y - v.x*u.y;
+    }
+    return 0.5f*std::fabs(a);
+}
+
+// cantos externos do primeiro e do último texel visível de cada linha do recorte
+inline std::vector<glm::vec2> opaqueOutline(const Image& img,int x0,int y0,int w,int h,
+                                            unsigned char alphaMin=1){
+    std::vector<glm::vec2> pts;
+    for(int y=0;y<h;++y){
+        const unsigned char* r = img.row(y0+y) + x0*4;
+        int l = -1, rr = -1;
+        for(int x=0;x<w;++x) if(r[x*4+3]>=alphaMin){ if(l<0) l = x; rr = x; }
+        if(l<0) continue;
+        float fy0 = (float)y/h, fy1 = (float)(y+1)/h;
+        pts.push_back({(float)l/w,     fy0}); pts.push_back({(float)l/w,     fy1});
+        pts.push_back({(float)(rr+1)/w,fy0}); pts.push_back({(float)(rr+1)/w,fy1});
+    }
+    return pts;
+}
+
+// monotone chain; devolve o casco em sentido anti-horário, sem colineares
+inline std::vector<glm::vec2> convexHull(std::vector<glm::vec2> pts){
+    std::sort(pts.begin(),pts.end(),[](glm::vec2 a,glm::vec2 b){
+        return a.x<b.x || (a.x==b.x && a.y<b.y);
+    });
+    if(pts.size()<3) return pts;
+    std::vector<glm::vec2> H(2*pts.size());
+    size_t k = 0;
+    for(size_t i=0;i<pts.size();++i){
+        while(k>=2 && cross2(H[k-2],H[k-1],pts[i])<=0) --k;
+        H[k++] = pts[i];
+    }
+    for(size_t i=pts.size()-1, t=k+1; i>0; --i){
+        while(k>=t && cross2(H[k-2],H[k-1],pts[i-1])<=0) --k;
+        H[k++] = pts[i-1];
+    }
+    H.resize(k-1);
+    return H;
+}
+
+// reduz o casco (anti-horário) a maxVerts vértices; o resultado continua
+// contendo o original e fica dentro de [0,1]² para não amostrar fora do recorte
+inline void reduceHull(std::vector<glm::vec2>& p,int maxVerts){
+    maxVerts = std::max(3,maxVerts);
+    while((int)p.size() > maxVerts){
+        int n = (int)p.size(), best = -1;
+        float bestArea = 1e30f;
+        glm::vec2 bestQ;
+        for(int i=0;i<n;++i){
+            glm::vec2 a = p[(i+n-1)%n], b = p[i], c = p[(i+1)%n], d = p[(i+2)%n];
+            glm::vec2 r = b - a, s = c - d;                  // a + t*r  ==  d + u*s
+            float den = r.x*s.y - r.y*s.x;
+            if(std::fabs(den) < 1e-9f) continue;
+            glm::vec2 ad = d - a;
+            float t = (ad.x*s.y - ad.y*s.x) / den;
+            float u = (ad.x*r.y - ad.y*r.x) / den;
+            if(t < 1.0f || u < 1.0f) continue;               // as arestas divergem
+            glm::vec2 q = a + r*t;
+            if(q.x < -1e-4f || q.y < -1e-4f || q.x > 1+1e-4f || q.y > 1+1e-4f) continue;
+            float area = 0.5f*std::fabs(cross2(b,q,c));
+            if(area < bestArea){ bestArea = area; best = i; bestQ = q; }
+        }
+        if(best<0) break;
+        p[best] = glm::clamp(bestQ, glm::vec2(0.0f), glm::vec2(1.0f));
+        p.erase(p.begin() + (best+1)%n);
+    }
+}
+
+// casco de no máximo maxVerts vértices para o recorte (x0,y0,w,h) da imagem;
+// sem texel visível, ou se não couber, devolve o próprio retângulo
+inline std::vector<glm::vec2> alphaHull(const Image& img,int x0,int y0,int w,int h,int maxVerts){
+    std::vector<glm::vec2> rect = { {0,0},{1,0},{1,1},{0,1} };
+    if(w<=0 || h<=0 || maxVerts<4) return rect;
+    std::vector<glm::vec2> hull = convexHull(opaqueOutline(img,x0,y0,w,h));
+    if(hull.size()<3) return rect;
+    reduceHull(hull,maxVerts);
+    if((int)hull.size() > maxVerts) return rect;
+    return hull;
+}
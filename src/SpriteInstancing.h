@@ -0,0 +1,268 @@
+// SpriteInstancing.h
+// Sprites instanciados: um registro empacotado por sprite (centro, tamanho,
+// rotação, retângulo de UV, tint) e um draw instanciado por textura. Dois
+// caminhos para o vertex shader ler o registro:
+//   - Attributes: o registro é um vertex buffer com divisor 1 (4 atributos
+//     por instância); sem base instance no 3.3, cada draw reaponta os
+//     atributos para o começo do seu trecho;
+//   - TexelFetch: o mesmo buffer visto como GL_TEXTURE_BUFFER (RGBA32UI, 3
+//     texels por sprite) e lido por gl_InstanceID; os floats voltam com
+//     uintBitsToFloat e o tint fica inteiro (visto como float, 0xFFFFFFFF é
+//     um NaN, e a GPU pode canonizar NaNs no fetch); nenhum vertex buffer
+//     ligado, só um VAO vazio, e o draw passa o início do trecho num uniform.
+// Nos dois, o canto do quad sai de gl_VertexID: não há VBO de quad unitário.
+//   - Points: sem instanciar; cada registro é um vértice GL_POINTS e um
+//     geometry shader o expande no quad (texScale/texOffset vindos do
+//     retângulo de UV). Os atributos ficam fixos e o draw usa first.
+// Os registros sobem pelo StreamBuffer uma vez por frame (flush), ou são
+// gravados direto no trecho reservado por tarefas paralelas (reserve +
+// submit, ver CommandList.h).
+
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "CommandList.h"
+#include "SpriteSheet.h"
+#include "StreamBuffer.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct SpriteInstance {
+    float    x, y, w, h;            // centro e tamanho em px
+    float    u0, v0, u1, v1;        // retângulo no atlas
+    float    rot, z;                // radianos, profundidade
+    uint32_t tint;                  // RGBA8, R no byte baixo
+    float    pad;
+};
+static_assert(sizeof(SpriteInstance) == 48, "SpriteInstance precisa ocupar 3 texels RGBA32UI");
+
+// quad do recorte do frame, como em SpriteBatch::draw
+inline SpriteInstance makeInstance(const SheetFrame& f,glm::vec2 pos,glm::vec2 scale,
+                                   float rot = 0.0f,uint32_t tint = 0xFFFFFFFFu,float z = 0.0f){
+    glm::vec2 c = pos + f.offset*scale, s = f.size*scale;
+    return { c.x, c.y, s.x, s.y, f.uv.x, f.uv.y, f.uv.z, f.uv.w, rot, z, tint, 0.0f };
+}
+
+// corpo comum: canto por gl_VertexID, rotação em torno do centro
+const char* const SPRITE_INSTANCE_GLSL = R"glsl(
+out vec2 UV;
+out vec4 vTint;
+const vec2 CORNER[6] = vec2[](vec2(0,0),vec2(1,0),vec2(1,1),vec2(0,0),vec2(1,1),vec2(0,1));
+void emit(vec4 rect,vec4 uv,vec2 rotZ,vec4 tint){
+    vec2 c = CORNER[gl_VertexID];
+    vec2 p = (c - 0.5) * rect.zw;
+    float s = sin(rotZ.x), k = cos(rotZ.x);
+    p = vec2(k*p.x - s*p.y, s*p.x + k*p.y) + rect.xy;
+    UV = mix(uv.xy, uv.zw, c);
+    vTint = tint;
+    gl_Position = projection * view * vec4(p, rotZ.y, 1);
+}
+)glsl";
+
+const char* const INSTANCE_ATTRIB_MAIN = R"glsl(
+layout(location=0) in vec4 iRect;
+layout(location=1) in vec4 iUV;
+layout(location=2) in vec2 iRotZ;
+layout(location=3) in vec4 iTint;
+void main(){ emit(iRect, iUV, iRotZ, iTint); }
+)glsl";
+
+const char* const INSTANCE_PULL_MAIN = R"glsl(
+uniform usamplerBuffer u_instances;
+uniform int u_base;             // primeiro registro deste draw
+void main(){
+    int i = (u_base + gl_InstanceID) * 3;
+    uvec4 r2 = texelFetch(u_instances, i+2);
+    uint t = r2.z;
+    vec4 tint = vec4(t & 0xFFu, (t>>8) & 0xFFu, (t>>16) & 0xFFu, t>>24) / 255.0;
+    emit(uintBitsToFloat(texelFetch(u_instances, i)), uintBitsToFloat(texelFetch(u_instances, i+1)),
+         uintBitsToFloat(r2.xy), tint);
+}
+)glsl";
+
+// registro passado inteiro ao geometry shader
+const char* const INSTANCE_POINT_VS = R"glsl(
+layout(location=0) in vec4 iRect;
+layout(location=1) in vec4 iUV;
+layout(location=2) in vec2 iRotZ;
+layout(location=3) in vec4 iTint;
+out Instance { vec4 rect; vec4 uv; vec2 rotZ; vec4 tint; } inst;
+void main(){
+    inst.rect = iRect; inst.uv = iUV; inst.rotZ = iRotZ; inst.tint = iTint;
+}
+)glsl";
+
+// um ponto -> strip de 4 vértices
+const char* const INSTANCE_POINT_GS = R"glsl(
+layout(points) in;
+layout(triangle_strip, max_vertices = 4) out;
+in Instance { vec4 rect; vec4 uv; vec2 rotZ; vec4 tint; } inst[];
+out vec2 UV;
+out vec4 vTint;
+void main(){
+    vec2 texScale  = inst[0].uv.zw - inst[0].uv.xy;
+    vec2 texOffset = inst[0].uv.xy;
+    float s = sin(inst[0].rotZ.x), k = cos(inst[0].rotZ.x);
+    for(int i=0;i<4;++i){
+        vec2 c = vec2(i & 1, i >> 1);
+        vec2 p = (c - 0.5) * inst[0].rect.zw;
+        p = vec2(k*p.x - s*p.y, s*p.x + k*p.y) + inst[0].rect.xy;
+        UV = c * texScale + texOffset;
+        vTint = inst[0].tint;
+        gl_Position = projection * view * vec4(p, inst[0].rotZ.y, 1);
+        EmitVertex();
+    }
+    EndPrimitive();
+}
+)glsl";
+
+// vertex shaders completos, para ShaderVariants(vs) com SH_VERTEX_TINT
+inline const char* instanceAttribVS(){
+    static const std::string s = std::string(SPRITE_INSTANCE_GLSL) + INSTANCE_ATTRIB_MAIN;
+    return s.c_str();
+}
+inline const char* instancePullVS(){
+    static const std::string s = std::string(SPRITE_INSTANCE_GLSL) + INSTANCE_PULL_MAIN;
+    return s.c_str();
+}
+
+const GLenum INSTANCE_TBO_UNIT = 1;     // GL_TEXTURE0 fica com o atlas
+
+enum class InstancePath { Attributes, TexelFetch, Points };
+
+struct SpriteInstancer {
+    InstancePath path = InstancePath::Attributes;
+    StreamBuffer stream;
+    GlVertexArray vao;
+    GlTexture     tbo;                      // só no caminho TexelFetch
+    GLuint program = 0;
+    GLint  locBase = -1;
+    int    layoutGen = -1;
+    int    draws = 0;                       // do último flush
+
+    // program = variante do caminho (instanceAttribVS / instancePullVS /
+    // INSTANCE_POINT_VS + INSTANCE_POINT_GS)
+    void init(InstancePath p,GLuint prog,size_t segmentBytes,StreamMode mode = StreamMode::Persistent){
+        path = p;
+        program = prog;
+        vao = GlVertexArray::create();
+        stream.init(segmentBytes,GL_ARRAY_BUFFER,mode);
+        if(path==InstancePath::TexelFetch){
+            tbo = GlTexture::create();
+            glUseProgram(program);
+            glUniform1i(glGetUniformLocation(program,"u_instances"),INSTANCE_TBO_UNIT);
+            locBase = glGetUniformLocation(program,"u_base");
+            GLint maxTexels = 0;
+            glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE,&maxTexels);
+            if((size_t)maxTexels < StreamBuffer::SEGMENTS*segmentBytes/16)
+                std::fprintf(stderr,"[instancias] stream maior que GL_MAX_TEXTURE_BUFFER_SIZE (%d texels)\n",maxTexels);
+        }
+    }
+
+    void begin(){ items.clear(); runs.clear(); }
+
+    void add(GLuint tex,const SpriteInstance& s){
+        if(runs.empty() || runs.back().tex != tex) runs.push_back({tex,(int)items.size(),0});
+        items.push_back(s);
+        ++runs.back().count;
+    }
+
+    // um upload e um draw (instanciado ou de pontos) por textura
+    void flush(){
+        draws = 0;
+        if(items.empty()) return;
+        size_t at = stream.write(items.data(),items.size()*sizeof(SpriteInstance),sizeof(SpriteInstance));
+        beginDraws();
+        for(const Run& r : runs) drawRun(at,r.tex,r.first,r.count);
+        endDraws();
+    }
+
+    // gravação paralela: count registros no stream para as tarefas
+    // preencherem; vale até o submit
+    SpriteInstance* reserve(int count){
+        span = stream.reserve(count*sizeof(SpriteInstance),sizeof(SpriteInstance));
+        return (SpriteInstance*)span.ptr;
+    }
+
+    // na thread do GL: fecha o trecho e executa as listas na ordem
+    void submit(const std::vector<CommandList>& lists){
+        draws = 0;
+        stream.commit(span);
+        beginDraws();
+        for(const CommandList& l : lists)
+            for(const SpriteCmd& c : l.cmds) drawRun(span.at,c.texture,c.first,c.count);
+        endDraws();
+    }
+
+private:
+    struct Run { GLuint tex; int first, count; };
+    std::vector<SpriteInstance> items;
+    std::vector<Run>            runs;
+    StreamSpan                  span;
+    GLuint                      boundTex = 0;
+
+    void beginDraws(){
+        if(layoutGen != stream.generation) bindLayout();
+        glUseProgram(program);
+        glBindVertexArray(vao);
+        if(path==InstancePath::TexelFetch){
+            glActiveTexture(GL_TEXTURE0 + INSTANCE_TBO_UNIT);
+            glBindTexture(GL_TEXTURE_BUFFER,tbo);
+            glActiveTexture(GL_TEXTURE0);
+        } else glBindBuffer(GL_ARRAY_BUFFER,stream.buffer);
+        boundTex = 0;
+    }
+
+    // registros [first, first+count) do trecho que começa em at
+    void drawRun(size_t at,GLuint tex,int first,int count){
+        if(tex != boundTex){ glBindTexture(GL_TEXTURE_2D,tex); boundTex = tex; }
+        int base = (int)(at/sizeof(SpriteInstance));
+        if(path==InstancePath::Points) glDrawArrays(GL_POINTS,base + first,count);
+        else {
+            if(path==InstancePath::TexelFetch) glUniform1i(locBase,base + first);
+            else pointAttributes(at + first*sizeof(SpriteInstance));
+            glDrawArraysInstanced(GL_TRIANGLES,0,6,count);
+        }
+        ++draws;
+    }
+
+    void endDraws(){
+        glBindVertexArray(0);
+        stream.endFrame();
+    }
+
+    void bindLayout(){
+        if(path==InstancePath::TexelFetch){
+            glBindTexture(GL_TEXTURE_BUFFER,tbo);
+            glTexBuffer(GL_TEXTURE_BUFFER,GL_RGBA32UI,stream.buffer);
+            glBindTexture(GL_TEXTURE_BUFFER,0);
+        } else {
+            glBindVertexArray(vao);
+            for(GLuint i=0;i<4;++i){
+                glEnableVertexAttribArray(i);
+                glVertexAttribDivisor(i,path==InstancePath::Points ? 0 : 1);
+            }
+            if(path==InstancePath::Points){       // fixos no começo do stream
+                glBindBuffer(GL_ARRAY_BUFFER,stream.buffer);
+                pointAttributes(0);
+            }
+            glBindVertexArray(0);
+        }
+        layoutGen = stream.generation;
+    }
+
+    // com o VAO ligado e o stream em GL_ARRAY_BUFFER
+    void pointAttributes(size_t at){
+        const GLsizei S = sizeof(SpriteInstance);
+        glVertexAttribPointer(0,4,GL_FLOAT,GL_FALSE,S,(void*)(at));
+        glVertexAttribPointer(1,4,GL_FLOAT,GL_FALSE,S,(void*)(at + 16));
+        glVertexAttribPointer(2,2,GL_FLOAT,GL_FALSE,S,(void*)(at + 32));
+        glVertexAttribPointer(3,4,GL_UNSIGNED_BYTE,GL_TRUE,S,(void*)(at + 40));
+    }
+};
@@ -0,0 +1,261 @@
+// SpriteSheet.h
+// Pré-processamento de spritesheets em grade (nRows x nCols células):
+// cada frame é recortado na bounding box do alfa, guarda o deslocamento
+// do recorte em relação ao centro da célula, e frames idênticos (hash +
+// comparação) são compartilhados. Os recortes únicos são empacotados em
+// prateleiras num atlas menor, que sobe comprimido (BC3) quando possível.
+// O quad de cada frame passa a cobrir só o recorte, e não a célula inteira;
+// opcionalmente, um casco convexo de poucos vértices (SpriteHull.h) cobre
+// só a parte visível do recorte.
+
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "GlHandle.h"
+#include "Image.h"
+#include "SpriteHull.h"
+#include "RenderPasses.h"
+#include "TextureLoader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+// um frame em coordenadas da célula (célula = quad unitário centrado na origem)
+struct SheetFrame {
+    glm::vec4 uv{0,0,0,0};        // (u0,v0,u1,v1) no atlas
+    glm::vec2 size{0,0};          // tamanho do recorte, em fração da célula
+    glm::vec2 offset{0,0};        // centro do recorte - centro da célula, em fração da célula
+    int       unique = -1;        // índice do recorte único (frames iguais compartilham)
+    int       x = 0, y = 0;       // origem do recorte no atlas (px)
+    int       w = 0, h = 0;       // tamanho do recorte (px); 0 = frame vazio
+    int       meshFirst = 0;      // triângulos do frame em SpriteSheet::meshVAO
+    int       meshCount = 6;      // (0,6) é sempre o quad do recorte inteiro
+    AlphaClass alpha = AlphaClass::Opaque;   // decide em quais passes o frame entra
+
+    bool empty() const { return size.x<=0 || size.y<=0; }
+};
+
+struct SpriteSheet {
+    GlTexture     tex;
+    GlVertexArray meshVAO;              // pos(2)+uv(2) no espaço do recorte
+    GlBuffer      meshVBO;
+    int    nRows = 1, nCols = 1;
+    int    cellW = 0, cellH = 0;
+    int    atlasW = 0, atlasH = 0;
+    int    uniqueFrames = 0;
+    std::vector<SheetFrame> frames;     // linha-major: frames[anim*nCols + frame]
+
+    const SheetFrame& frame(int anim,int f) const { return frames[anim*nCols + f]; }
+
+    // textura inteira como um único frame, sem recorte (ex.: o fundo),
+    // desenhada com a malha só do quad unitário
+    static SpriteSheet whole(GlTexture tex);
+};
+
+// quad unitário pos(2)+uv(2): os 6 primeiros vértices de toda malha de folha
+inline std::vector<float> unitQuadVertices(){
+    return {
+        // pos      // uv
+        -0.5f,  0.5f,   0.0f,1.0f,
+         0.5f, -0.5f,   1.0f,0.0f,
+        -0.5f, -0.5f,   0.0f,0.0f,
+        -0.5f,  0.5f,   0.0f,1.0f,
+         0.5f,  0.5f,   1.0f,1.0f,
+         0.5f, -0.5f,   1.0f,0.0f
+    };
+}
+
+// sobe a malha pos(2)+uv(2) no VAO/VBO da folha (o anterior vai para a fila)
+inline void uploadSheetMesh(SpriteSheet& sheet,const std::vector<float>& V){
+    sheet.meshVAO = GlVertexArray::create();
+    sheet.meshVBO = GlBuffer::create();
+    glBindVertexArray(sheet.meshVAO);
+      glBindBuffer(GL_ARRAY_BUFFER,sheet.meshVBO);
+      glBufferData(GL_ARRAY_BUFFER,V.size()*sizeof(float),V.data(),GL_STATIC_DRAW);
+      glEnableVertexAttribArray(0);
+      glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,4*sizeof(float),(void*)0);
+      glEnableVertexAttribArray(1);
+      glVertexAttribPointer(1,2,GL_FLOAT,GL_FALSE,4*sizeof(float),(void*)(2*sizeof(float)));
+    glBindVertexArray(0);
+}
+
+inline SpriteSheet SpriteSheet::whole(GlTexture tex){
+    SpriteSheet s;
+    s.tex = std::move(tex);
+    uploadSheetMesh(s,unitQuadVertices());
+    SheetFrame f;
+    f.uv = {0,0,1,1}; f.size = {1,1}; f.unique = 0;
+    s.frames.push_back(f);
+    s.uniqueFrames = 1;
+    return s;
+}
+
+// FNV-1a 64 sobre as dimensões e os pixels do recorte
+inline uint64_t hashRegion(const Image& img,int x0,int y0,int w,int h){
+    uint64_t hsh = 1469598103934665603ull;
+    auto mix = [&](const unsigned char* p,size_t n){
+        for(size_t i=0;i<n;++i){ hsh ^= p[i]; hsh *= 1099511628211ull; }
+    };
+    mix((const unsigned char*)&w,sizeof w);
+    mix((const unsigned char*)&h,sizeof h);
+    for(int y=0;y<h;++y) mix(img.row(y0+y) + x0*4, (size_t)w*4);
+    return hsh;
+}
+
+inline bool sameRegion(const Image& img,int ax,int ay,int bx,int by,int w,int h){
+    for(int y=0;y<h;++y)
+        if(std::memcmp(img.row(ay+y)+ax*4, img.row(by+y)+bx*4, (size_t)w*4)!=0) return false;
+    return true;
+}
+
+// recorta, deduplica e empacota; devolve o atlas e preenche sheet.frames.
+// Linha 0 da imagem é a base (stbi com flip), então a animação 0 é a última linha.
+inline Image buildSheetAtlas(const Image& src,int nRows,int nCols,SpriteSheet& sheet,int pad=2){
+    sheet.nRows = nRows; sheet.nCols = nCols;
+    sheet.cellW = src.w / nCols; sheet.cellH = src.h / nRows;
+    sheet.frames.assign(nRows*nCols, SheetFrame{});
+
+    struct Region { int sx, sy, w, h, ax = 0, ay = 0; };
+    std::vector<Region> uniq;
+    std::unordered_multimap<uint64_t,int> byHash;
+
+    for(int a=0;a<nRows;++a)
+        for(int c=0;c<nCols;++c){
+            int cx = c*sheet.cellW, cy = (nRows-1-a)*sheet.cellH;
+            int x0 = sheet.cellW, y0 = sheet.cellH, x1 = -1, y1 = -1;
+            for(int y=0;y<sheet.cellH;++y){
+                const unsigned char* r = src.row(cy+y) + cx*4;
+                for(int x=0;x<sheet.cellW;++x)
+                    if(r[x*4+3]){ x0=std::min(x0,x); x1=std::max(x1,x); y0=std::min(y0,y); y1=std::max(y1,y); }
+            }
+            SheetFrame& f = sheet.frames[a*nCols + c];
+            if(x1<0) continue;                              // frame vazio
+            f.w = x1-x0+1; f.h = y1-y0+1;
+            f.size   = { (float)f.w/sheet.cellW, (float)f.h/sheet.cellH };
+            f.offset = { (x0 + f.w*0.5f)/sheet.cellW - 0.5f, (y0 + f.h*0.5f)/sheet.cellH - 0.5f };
+            f.alpha  = classifyAlpha(src,cx+x0,cy+y0,f.w,f.h);
+
+            uint64_t hsh = hashRegion(src,cx+x0,cy+y0,f.w,f.h);
+            auto range = byHash.equal_range(hsh);
+            for(auto it=range.first; it!=range.second; ++it){
+                const Region& r = uniq[it->second];
+                if(r.w==f.w && r.h==f.h && sameRegion(src,r.sx,r.sy,cx+x0,cy+y0,f.w,f.h)){
+                    f.unique = it->second; break;
+                }
+            }
+            if(f.unique<0){
+                f.unique = (int)uniq.size();
+                uniq.push_back({cx+x0, cy+y0, f.w, f.h});
+                byHash.emplace(hsh,f.unique);
+            }
+        }
+    sheet.uniqueFrames = (int)uniq.size();
+
+    // prateleiras, do mais alto para o mais baixo; largura ~ raiz da área total
+    std::vector<int> order(uniq.size());
+    std::iota(order.begin(),order.end(),0);
+    std::sort(order.begin(),order.end(),[&](int a,int b){ return uniq[a].h > uniq[b].h; });
+    size_t area = 0; int widest = 1;
+    for(auto& r : uniq){ area += (size_t)(r.w+pad)*(r.h+pad); widest = std::max(widest, r.w+pad); }
+    int atlasW = std::max(widest, (int)std::ceil(std::sqrt((double)area)));
+    atlasW = (atlasW + 3) & ~3;                               // múltiplo de 4 para BC3
+
+    int x = 0, y = 0, shelfH = 0;
+    for(int i : order){
+        Region& r = uniq[i];
+        if(x + r.w + pad > atlasW){ x = 0; y += shelfH; shelfH = 0; }
+        r.ax = x + pad/2; r.ay = y + pad/2;
+        x += r.w + pad; shelfH = std::max(shelfH, r.h + pad);
+    }
+    int atlasH = std::max(4, (y + shelfH + 3) & ~3);
+
+    Image atlas(atlasW,atlasH);                               // zerado = transparente
+    for(auto& r : uniq)
+        for(int yy=0; yy<r.h; ++yy)
+            std::memcpy(atlas.row(r.ay+yy) + r.ax*4, src.row(r.sy+yy) + r.sx*4, (size_t)r.w*4);
+
+    for(auto& f : sheet.frames){
+        if(f.empty()) continue;
+        const Region& r = uniq[f.unique];
+        f.x = r.ax; f.y = r.ay;
+        f.uv = { (float)r.ax/atlasW, (float)r.ay/atlasH,
+                 (float)(r.ax+r.w)/atlasW, (float)(r.ay+r.h)/atlasH };
+    }
+    sheet.atlasW = atlasW; sheet.atlasH = atlasH;
+    return atlas;
+}
+
+// malha com o quad unitário nos 6 primeiros vértices e, em seguida, o casco
+// (em leque) de cada recorte único; devolve a fração média do recorte coberta
+inline float buildSheetMesh(const Image& atlas,SpriteSheet& sheet,int hullVerts){
+    std::vector<float> V = unitQuadVertices();
+    std::vector<int> first(sheet.uniqueFrames,-1), count(sheet.uniqueFrames,0);
+    float coverage = 0; int n = 0;
+    for(auto& f : sheet.frames){
+        if(f.empty()) continue;
+        if(first[f.unique]<0){
+            std::vector<glm::vec2> hull = alphaHull(atlas,f.x,f.y,f.w,f.h,hullVerts);
+            first[f.unique] = (int)V.size()/4;
+            for(size_t i=1; i+1<hull.size(); ++i)
+                for(const glm::vec2& q : { hull[0], hull[i], hull[i+1] }){
+                    V.push_back(q.x-0.5f); V.push_back(q.y-0.5f);
+                    V.push_back(q.x);      V.push_back(q.y);
+                }
+            count[f.unique] = (int)V.size()/4 - first[f.unique];
+            coverage += polygonArea(hull); ++n;
+        }
+        f.meshFirst = first[f.unique];
+        f.meshCount = count[f.unique];
+    }
+
+    uploadSheetMesh(sheet,V);
+    return n ? coverage/n : 1.0f;
+}
+
+// processa e sobe o atlas (BC3 quando o driver suporta), registrando as estatísticas.
+// hullVerts: máximo de vértices do casco de cada frame (< 4 = só o quad do recorte)
+inline SpriteSheet uploadSpriteSheet(const char* path,const Image& src,int nRows,int nCols,
+                                     int hullVerts=8){
+    using clk = std::chrono::steady_clock;
+    SpriteSheet sheet;
+    auto t0 = clk::now();
+    Image atlas = buildSheetAtlas(src,nRows,nCols,sheet);
+    CompressedTexture ct;
+    bool bc = compressedTexturesSupported();
+    if(bc) ct = compressWithMips(atlas,BlockFormat::BC3);
+    auto t1 = clk::now();
+    sheet.tex = bc ? uploadCompressed(ct,0) : uploadTexture(atlas);
+    auto t2 = clk::now();
+    float hullCoverage = buildSheetMesh(atlas,sheet,hullVerts);
+
+    TextureStats s;
+    s.path   = path;
+    s.format = bc ? "BC3" : "RGBA8";
+    s.srcW = src.w;  s.srcH = src.h;
+    s.w = atlas.w;   s.h = atlas.h;
+    s.srcBytes = mipChainBytes(src.w,src.h);
+    s.bytes    = bc ? ct.bytes() : mipChainBytes(atlas.w,atlas.h);
+    s.resizeMs = std::chrono::duration<double,std::milli>(t1-t0).count();
+    s.uploadMs = std::chrono::duration<double,std::milli>(t2-t1).count();
+    textureStats().push_back(s);
+
+    size_t cellArea = 0, trimArea = 0;
+    int translucent = 0;
+    for(auto& f : sheet.frames){
+        cellArea += (size_t)sheet.cellW*sheet.cellH; trimArea += (size_t)f.w*f.h;
+        translucent += f.alpha==AlphaClass::Translucent;
+    }
+    double trimmed = cellArea ? (double)trimArea/cellArea : 0.0;
+    std::printf("[sheet] %-32s %d frames, %d únicos, %d translúcidos, recorte %.1f%% da célula, casco %.1f%%\n",
+                path, (int)sheet.frames.size(), sheet.uniqueFrames, translucent,
+                100.0*trimmed, 100.0*trimmed*hullCoverage);
+    return sheet;
+}
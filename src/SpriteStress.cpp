@@ -0,0 +1,579 @@
+// SpriteStress.cpp
+// Cena de estresse / benchmark: o fundo e N gangsters animados andando pela
+// tela, desenhados por cada caminho de renderização em sequência. Para cada
+// caminho mede o tempo de CPU e de GPU por frame e quantos fragmentos foram
+// gerados (GL_SAMPLES_PASSED), e no fim imprime uma tabela comparativa.
+// Depois mede, só na CPU, como o trabalho de um frame (animação, culling e
+// montagem das instâncias) escala de 1 a N threads no JobSystem.
+// OpenGL 3.3 + GLFW + GLAD + GLM + stb_image.
+//
+// uso: SpriteStress [nSprites=2000] [framesPorCaminho=300] [atoresEscala=100000]
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "HeapCount.h"
+#include "GpuTrack.h"
+
+#define STBI_MALLOC(n)    heapAlloc(n)
+#define STBI_REALLOC(p,n) heapRealloc(p,n)
+#define STBI_FREE(p)      heapFree(p)
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "TextureLoader.h"
+#include "SpriteSheet.h"
+#include "RenderQueue.h"
+#include "DebugDraw.h"
+#include "SpriteBatch.h"
+#include "SpriteInstancing.h"
+#include "CommandList.h"
+#include "SpriteClips.h"
+#include "SpriteArray.h"
+#include "MultiTexBatch.h"
+#include "ShaderVariants.h"
+#include "FrameUniforms.h"
+#include "GlHandle.h"
+#include "JobSystem.h"
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// dimensão da janela
+const unsigned int SCR_W = 800, SCR_H = 600;
+const glm::vec2 CELL = { 64.0f, 64.0f };    // tamanho de cada gangster na tela
+const int ACTOR_GRAIN = 1024;               // atores por tarefa
+const int MEM_SAMPLE_EVERY = 30;            // frames entre amostras de memória
+
+// pode rodar em qualquer thread (o flip do stbi é ligado uma vez no main)
+Image loadImage(const char* path,int fitW=0,int fitH=0){
+    int w,h,n;
+    unsigned char* data = stbi_load(path,&w,&h,&n,4);
+    if(!data){ std::cerr<<"Erro ao carregar "<<path<<"\n"; return Image(); }
+    Image img = Image::fromRGBA(w,h,data);
+    stbi_image_free(data);
+    return fitToTarget(std::move(img),fitW,fitH);
+}
+
+// um gangster andando e quicando nas bordas
+struct Actor {
+    glm::vec2 pos, vel;
+    const SpriteSheet* sheet;
+    int   frame = 0;
+    float acc = 0, frameDur = 0.1f;
+
+    void Update(float dt){
+        pos += vel*dt;
+        if(pos.x<0 || pos.x>SCR_W) { vel.x = -vel.x; pos.x = glm::clamp(pos.x,0.0f,(float)SCR_W); }
+        if(pos.y<0 || pos.y>SCR_H) { vel.y = -vel.y; pos.y = glm::clamp(pos.y,0.0f,(float)SCR_H); }
+        acc += dt;
+        while(acc>=frameDur){ frame = (frame+1)%sheet->nCols; acc -= frameDur; }
+    }
+};
+
+// um caminho de renderização a comparar; cpuAnim = false quando o caminho
+// anima na GPU e dispensa o Actor::Update da CPU
+struct BenchPath {
+    const char* name;
+    std::function<void()> draw;
+    bool cpuAnim = true;
+};
+
+struct BenchResult {
+    const char* name;
+    double cpuMs = 0, gpuMs = 0, fragments = 0, stateChanges = 0, draws = 0;
+};
+
+int main(int argc,char** argv){
+    int nSprites = argc>1 ? std::atoi(argv[1]) : 2000;
+    int nFrames  = argc>2 ? std::atoi(argv[2]) : 300;
+    int nScale   = argc>3 ? std::atoi(argv[3]) : 100000;
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR,3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR,3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE,GLFW_OPENGL_CORE_PROFILE);
+    GLFWwindow* win = glfwCreateWindow(SCR_W,SCR_H,"Sprite Stress",nullptr,nullptr);
+    glfwMakeContextCurrent(win);
+    gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    installGpuTracking();
+    glfwSwapInterval(0);
+
+    glViewport(0,0,SCR_W,SCR_H);
+    currentMemTag = MemTag::Shaders;
+    // mesma variante do mundo nas demos de textura (faixa de alfa por passe)
+    // e o programa dos contornos, compilando em lote durante a carga
+    ProgramBatch programs(win);
+    ShaderVariants shaders;
+    shaders.request(programs,SH_ALPHA_TEST);
+    // instâncias: registro por atributos ou lido de um texture buffer
+    ShaderVariants attribShaders(instanceAttribVS()), pullShaders(instancePullVS());
+    attribShaders.request(programs,SH_VERTEX_TINT);
+    pullShaders.request(programs,SH_VERTEX_TINT);
+    // ou um ponto por sprite, expandido no geometry shader
+    ShaderVariants pointShaders(INSTANCE_POINT_VS,SPRITE_FS,INSTANCE_POINT_GS);
+    pointShaders.request(programs,SH_VERTEX_TINT);
+    // animação e movimento calculados no vertex shader
+    ShaderVariants animShaders(animatedVS());
+    animShaders.request(programs,SH_VERTEX_TINT);
+    animShaders.request(programs,SH_VERTEX_TINT|SH_TEXTURE_ARRAY);
+    DebugDraw debug;
+    debug.init(&programs);
+    // lote com várias texturas ligadas ao mesmo tempo
+    MultiTexBatch multi;
+    multi.init(&programs,(nSprites+1)*6*sizeof(MultiTexVertex) + 4096);
+
+    // fundo (sem recorte) e duas folhas de gangster, decodificados em paralelo
+    currentMemTag = MemTag::Sprites;
+    JobSystem& jobs = jobSystem();
+    stbi_set_flip_vertically_on_load(true);
+    Image bgImg, walkImg, runImg;
+    JobCounter decoded;
+    jobs.submit([&]{ MemTagScope tag(MemTag::Images); bgImg   = loadImage("resources/background.png",SCR_W,SCR_H); },&decoded);
+    jobs.submit([&]{ MemTagScope tag(MemTag::Images); walkImg = loadImage("resources/Gangsters/Walk.png",10*(int)CELL.x,(int)CELL.y); },&decoded);
+    jobs.submit([&]{ MemTagScope tag(MemTag::Images); runImg  = loadImage("resources/Gangsters/Run.png", 10*(int)CELL.x,(int)CELL.y); },&decoded);
+    jobs.wait(decoded);
+    SpriteSheet bgSheet = uploadSpriteSheet("resources/background.png",bgImg,1,1,4);
+    SpriteSheet walk = uploadSpriteSheet("resources/Gangsters/Walk.png",walkImg,1,10);
+    SpriteSheet run  = uploadSpriteSheet("resources/Gangsters/Run.png", runImg, 1,10);
+    // as mesmas folhas como camadas de um array: walk e run num único bind
+    SpriteArray gangster = uploadSpriteArray("Gangsters (walk+run)",
+                                             { {"walk",&walkImg,1,10}, {"run",&runImg,1,10} });
+    printTextureStats();
+
+    currentMemTag = MemTag::Shaders;
+    programs.finish();
+    programs.print();
+    printProgramCacheStats();
+    currentMemTag = MemTag::Render;
+    GLuint shader = shaders.get<SH_ALPHA_TEST>();
+    shaders.setCommon();
+    attribShaders.setCommon();
+    pullShaders.setCommon();
+    pointShaders.setCommon();
+    animShaders.setCommon();
+    FrameUniforms frame;
+    frame.init();
+    frame.data.projection = glm::ortho(0.0f,(float)SCR_W,0.0f,(float)SCR_H,-1.0f,1.0f);
+    frame.setViewport(0,0,SCR_W,SCR_H);
+    glUseProgram(shader);
+    GLint locModel     = glGetUniformLocation(shader,"model");
+    GLint locTexScale  = glGetUniformLocation(shader,"texScale");
+    GLint locTexOffset = glGetUniformLocation(shader,"texOffset");
+    GLint locAlphaCut  = glGetUniformLocation(shader,"u_alphaCut");
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> ux(0,SCR_W), uy(0,SCR_H), uv(-120,120);
+    std::vector<Actor> actors(nSprites);
+    for(int i=0;i<nSprites;++i){
+        actors[i].pos   = { ux(rng), uy(rng) };
+        actors[i].vel   = { uv(rng), uv(rng) };
+        actors[i].sheet = (i&1) ? &run : &walk;
+        actors[i].frame = i % 10;
+    }
+
+    // trocas de programa/textura/VAO e draws no frame corrente, informados por cada caminho
+    int frameStateChanges = 0, frameDraws = 0;
+
+    // desenho de um frame com a malha escolhida (casco ou quad do recorte) em z
+    auto drawFrame = [&](const SpriteSheet& s,const SheetFrame& f,glm::vec2 pos,glm::vec2 scale,
+                         bool hull,float z,AlphaCut cut){
+        if(f.empty()) return;
+        glm::mat4 M = glm::translate(glm::mat4(1.0f), glm::vec3(pos + f.offset*scale,z))
+                    * glm::scale   (glm::mat4(1.0f), glm::vec3(f.size*scale,1.0f));
+        glUniformMatrix4fv(locModel,1,GL_FALSE,glm::value_ptr(M));
+        glUniform2f(locTexScale, f.uv.z-f.uv.x, f.uv.w-f.uv.y);
+        glUniform2f(locTexOffset,f.uv.x, f.uv.y);
+        glUniform2f(locAlphaCut, cut.lo, cut.hi);
+        glBindTexture(GL_TEXTURE_2D,s.tex);
+        glBindVertexArray(s.meshVAO);
+        frameStateChanges += 2;
+        ++frameDraws;
+        if(hull) glDrawArrays(GL_TRIANGLES,f.meshFirst,f.meshCount);
+        else     glDrawArrays(GL_TRIANGLES,0,6);
+    };
+    const glm::vec2 bgPos = {SCR_W*0.5f,SCR_H*0.5f}, bgScale = {(float)SCR_W,(float)SCR_H};
+    const float BG_Z = -0.9f;
+    // ordem do pintor = índice do ator; vira profundidade no caminho com depth
+    auto actorZ = [&](int i){ return -0.8f + 1.6f*(i+1)/(nSprites+1); };
+
+    // fundo e atores na ordem do código, tudo com blend
+    auto drawScene = [&](bool hull){
+        glUseProgram(shader);
+        frameStateChanges = 1;
+        frameDraws = 0;
+        glActiveTexture(GL_TEXTURE0);
+        drawFrame(bgSheet,bgSheet.frames[0],bgPos,bgScale,false,BG_Z,CUT_NONE);
+        for(const Actor& a : actors)
+            drawFrame(*a.sheet,a.sheet->frame(0,a.frame),a.pos,CELL,hull,0.0f,CUT_NONE);
+    };
+
+    // passe opaco da frente para trás com depth, depois só as bordas translúcidas
+    std::vector<PassItem> opaque, translucent;
+    auto drawScenePasses = [&]{
+        opaque.clear(); translucent.clear();
+        for(int i=0;i<nSprites;++i){
+            const SheetFrame& f = actors[i].sheet->frame(0,actors[i].frame);
+            if(f.empty()) continue;
+            opaque.push_back({actorZ(i),i});
+            if(f.alpha==AlphaClass::Translucent) translucent.push_back({actorZ(i),i});
+        }
+        sortFrontToBack(opaque);
+        sortBackToFront(translucent);
+
+        glUseProgram(shader);
+        frameStateChanges = 1;
+        frameDraws = 0;
+        glActiveTexture(GL_TEXTURE0);
+        beginOpaquePass();
+        for(const PassItem& it : opaque){
+            const Actor& a = actors[it.index];
+            const SheetFrame& f = a.sheet->frame(0,a.frame);
+            drawFrame(*a.sheet,f,a.pos,CELL,true,it.z,opaqueCut(f.alpha));
+        }
+        drawFrame(bgSheet,bgSheet.frames[0],bgPos,bgScale,false,BG_Z,opaqueCut(bgSheet.frames[0].alpha));
+        beginTranslucentPass();
+        for(const PassItem& it : translucent){
+            const Actor& a = actors[it.index];
+            drawFrame(*a.sheet,a.sheet->frame(0,a.frame),a.pos,CELL,true,it.z,CUT_TRANSLUCENT);
+        }
+        endPasses();
+    };
+
+    // mesma cena pela fila com chave de 64 bits: agrupa por textura no passe opaco
+    RenderQueue queue;
+    auto drawSceneQueue = [&]{
+        queue.clear();
+        submitSprite(queue,shader,0,bgSheet,bgSheet.frames[0],bgPos,bgScale,BG_Z);
+        for(int i=0;i<nSprites;++i){
+            const Actor& a = actors[i];
+            submitSprite(queue,shader,1,*a.sheet,a.sheet->frame(0,a.frame),a.pos,CELL,actorZ(i));
+        }
+        queue.sort();
+        glActiveTexture(GL_TEXTURE0);
+        queue.execute();
+        frameStateChanges = queue.stats.stateChanges();
+        frameDraws = queue.stats.draws;
+    };
+
+    // a fila mais um contorno por ator, todos num único draw de depuração
+    auto drawSceneOutlined = [&]{
+        drawSceneQueue();
+        for(const Actor& a : actors) debug.rect(a.pos,CELL,glm::vec4(1,1,1,1),1.0f);
+        debug.flush();
+        frameStateChanges += 2;
+        ++frameDraws;
+    };
+
+    // quads expandidos na CPU e enviados pelo StreamBuffer, um lote por modo
+    // de envio; agrupado por folha (a ordem entre folhas não importa aqui)
+    // ou, com painter, na ordem dos atores: o lote quebra a cada troca de folha
+    const StreamMode batchModes[3] = { StreamMode::Persistent, StreamMode::Unsynchronized, StreamMode::Orphan };
+    SpriteBatch batches[3];
+    for(int i=0;i<3;++i) batches[i].init((nSprites+1)*6*sizeof(SpriteVertex) + 4096,batchModes[i]);
+    auto drawSceneBatch = [&](SpriteBatch& b,bool painter){
+        glActiveTexture(GL_TEXTURE0);
+        b.begin(shader);
+        glUniform2f(locAlphaCut,CUT_NONE.lo,CUT_NONE.hi);
+        b.draw(bgSheet.tex,bgSheet.frames[0],bgPos,bgScale);
+        if(painter)
+            for(const Actor& a : actors) b.draw(a.sheet->tex,a.sheet->frame(0,a.frame),a.pos,CELL);
+        else
+            for(const SpriteSheet* s : {&walk,&run})
+                for(const Actor& a : actors)
+                    if(a.sheet==s) b.draw(s->tex,s->frame(0,a.frame),a.pos,CELL);
+        b.end();
+        frameStateChanges = 1 + b.draws;
+        frameDraws = b.draws;
+    };
+
+    // mesma ordem do pintor, com fundo e as duas folhas ligados ao mesmo tempo
+    auto drawSceneMultiTex = [&]{
+        multi.begin();
+        multi.draw(bgSheet.tex,bgSheet.frames[0],bgPos,bgScale);
+        for(const Actor& a : actors) multi.draw(a.sheet->tex,a.sheet->frame(0,a.frame),a.pos,CELL);
+        multi.end();
+        frameStateChanges = 1 + 3*multi.draws;
+        frameDraws = multi.draws;
+    };
+
+    // um registro por sprite e um draw instanciado por folha
+    size_t instanceBytes = (nSprites+1)*sizeof(SpriteInstance) + 4096;
+    SpriteInstancer attribInst, pullInst, pointInst;
+    attribInst.init(InstancePath::Attributes,attribShaders.get<SH_VERTEX_TINT>(),instanceBytes);
+    pullInst.init  (InstancePath::TexelFetch,pullShaders.get<SH_VERTEX_TINT>(),instanceBytes);
+    pointInst.init (InstancePath::Points,    pointShaders.get<SH_VERTEX_TINT>(),instanceBytes);
+    auto drawSceneInstanced = [&](SpriteInstancer& in){
+        glActiveTexture(GL_TEXTURE0);
+        in.begin();
+        in.add(bgSheet.tex,makeInstance(bgSheet.frames[0],bgPos,bgScale));
+        for(const SpriteSheet* s : {&walk,&run})
+            for(const Actor& a : actors)
+                if(a.sheet==s) in.add(s->tex,makeInstance(s->frame(0,a.frame),a.pos,CELL));
+        in.flush();
+        frameStateChanges = 1 + in.draws;
+        frameDraws = in.draws;
+    };
+
+    // multidão animada na GPU: fotografa os atores na entrada do caminho e
+    // depois só reenvia quem troca de estado (~1% por frame, nova velocidade)
+    // (no array, clipes são intervalos de camadas e a multidão inteira é um draw)
+    ClipTable clips;
+    const uint32_t walkClip = clips.add(walk,0,10.0f), runClip = clips.add(run,0,10.0f);
+    const uint32_t walkLayers = clips.addLayers(gangster,gangster.clip("walk"),10.0f);
+    const uint32_t runLayers  = clips.addLayers(gangster,gangster.clip("run"), 10.0f);
+    clips.upload();
+    const glm::vec2 viewport((float)SCR_W,(float)SCR_H);
+    AnimatedCrowd crowd, arrayCrowd;
+    crowd.init(animShaders.get<SH_VERTEX_TINT>(),viewport);
+    arrayCrowd.init(animShaders.get<SH_VERTEX_TINT|SH_TEXTURE_ARRAY>(),viewport,GL_TEXTURE_2D_ARRAY);
+    std::uniform_int_distribution<int> pick(0,nSprites-1);
+    std::uniform_real_distribution<float> rate(0.5f,2.0f);
+    double animUploads = 0;
+    int    animFrames = 0;
+    auto drawSceneGpuAnim = [&](AnimatedCrowd& c,bool layers){
+        double now = frame.data.time.x;
+        if(c.items.empty()){
+            for(const SpriteSheet* s : {&walk,&run})
+                for(const Actor& a : actors){
+                    if(a.sheet!=s) continue;
+                    float phase = a.frame*a.frameDur + a.acc;     // mesmo frame de agora
+                    glm::vec2 p0 = a.pos - a.vel*phase;
+                    uint32_t clip = layers ? (s==&walk ? walkLayers : runLayers) : (s==&walk ? walkClip : runClip);
+                    c.add(layers ? gangster.tex : s->tex,
+                          { p0.x, p0.y, a.vel.x, a.vel.y, CELL.x, CELL.y, (float)(now - phase), 1.0f, clip, 0xFFFFFFFFu });
+                }
+        }
+        for(int k=0;k<nSprites/100;++k){
+            int i = pick(rng);
+            c.play(i,c.items[i].clip,rate(rng),now);
+        }
+        glUseProgram(shader);
+        glActiveTexture(GL_TEXTURE0);
+        drawFrame(bgSheet,bgSheet.frames[0],bgPos,bgScale,false,BG_Z,CUT_NONE);
+        c.draw();
+        frameStateChanges = 3 + c.draws;
+        frameDraws = 1 + c.draws;
+        animUploads += c.uploaded;
+        ++animFrames;
+    };
+
+    // gravação paralela: as tarefas montam os registros direto no trecho
+    // reservado do stream e anotam listas de comandos; o envio fica nesta
+    // thread. Atores agrupados por folha, para as listas emendarem os
+    // draws, e descartados fora da janela
+    const glm::vec2 viewMin = -CELL*0.5f, viewMax = glm::vec2(SCR_W,SCR_H) + CELL*0.5f;
+    std::vector<int> bySheet;
+    for(const SpriteSheet* s : {&walk,&run})
+        for(int i=0;i<nSprites;++i) if(actors[i].sheet==s) bySheet.push_back(i);
+    SpriteInstancer recordInst;
+    recordInst.init(InstancePath::Points,pointShaders.get<SH_VERTEX_TINT>(),instanceBytes);
+    std::vector<CommandList> lists;
+    std::unique_ptr<JobSystem> recordJobs;          // um por vez, com o nº de threads do caminho
+    auto drawSceneRecorded = [&](unsigned threads){
+        if(!recordJobs || recordJobs->threads()!=threads) recordJobs.reset(new JobSystem(threads));
+        glActiveTexture(GL_TEXTURE0);
+        SpriteInstance* out = recordInst.reserve(nSprites+1);
+        recordParallel(*recordJobs,out,nSprites+1,ACTOR_GRAIN,lists,[&](int i,SpriteInstance& dst)->uint32_t{
+            if(i==0){ dst = makeInstance(bgSheet.frames[0],bgPos,bgScale); return bgSheet.tex; }
+            const Actor& a = actors[bySheet[i-1]];
+            if(a.pos.x<viewMin.x || a.pos.y<viewMin.y || a.pos.x>viewMax.x || a.pos.y>viewMax.y) return 0;
+            dst = makeInstance(a.sheet->frame(0,a.frame),a.pos,CELL);
+            return a.sheet->tex;
+        });
+        recordInst.submit(lists);
+        frameStateChanges = 1 + recordInst.draws;
+        frameDraws = recordInst.draws;
+    };
+
+    std::vector<BenchPath> paths = {
+        { "quad do recorte",     [&]{ drawScene(false); } },
+        { "casco alfa",          [&]{ drawScene(true);  } },
+        { "opaco+translucido",   [&]{ drawScenePasses(); } },
+        { "fila radix",          [&]{ drawSceneQueue(); } },
+        { "fila + contornos",    [&]{ drawSceneOutlined(); } },
+        { "lote persistente",    [&]{ drawSceneBatch(batches[0],false); } },
+        { "lote map sem sincr.", [&]{ drawSceneBatch(batches[1],false); } },
+        { "lote orfanizado",     [&]{ drawSceneBatch(batches[2],false); } },
+        { "lote, ordem pintor",  [&]{ drawSceneBatch(batches[0],true); } },
+        { "multi-textura",       [&]{ drawSceneMultiTex(); } },
+        { "inst. atributos",     [&]{ drawSceneInstanced(attribInst); } },
+        { "inst. texel fetch",   [&]{ drawSceneInstanced(pullInst); } },
+        { "pontos + GS",         [&]{ drawSceneInstanced(pointInst); } },
+        { "animação na GPU",     [&]{ drawSceneGpuAnim(crowd,false); }, false },
+        { "anim. GPU + array",   [&]{ drawSceneGpuAnim(arrayCrowd,true); }, false },
+    };
+    unsigned maxThreads = std::max(1u,std::thread::hardware_concurrency());
+    std::deque<std::string> recordNames;
+    for(unsigned n=1;;n = std::min(maxThreads,n*2)){
+        recordNames.push_back("gravação, " + std::to_string(n) + " thr.");
+        paths.push_back({ recordNames.back().c_str(), [&,n]{ drawSceneRecorded(n); } });
+        if(n==maxThreads) break;
+    }
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
+
+    // consultas em pares: lê-se sempre a do frame anterior, sem esperar a GPU
+    GLuint qSamples[2], qTime[2];
+    glGenQueries(2,qSamples);
+    glGenQueries(2,qTime);
+
+    // série temporal do heap e dos objetos GL ao longo dos caminhos: o que
+    // sobe e não desce de um caminho para o outro é vazamento
+    struct MemSample {
+        const char* path; int frame;
+        HeapTotals  heap;
+        GpuKindStats buffers, textures, vaos, programs;
+    };
+    std::vector<MemSample> memSamples;
+    memSamples.reserve(paths.size()*(nFrames/MEM_SAMPLE_EVERY + 2));
+    auto sampleMem = [&](const char* name,int f){
+        GpuTracker& t = gpuTracker();
+        memSamples.push_back({ name, f, heapTotals(), t.get(GpuKind::Buffer), t.get(GpuKind::Texture),
+                               t.get(GpuKind::VertexArray), t.get(GpuKind::Program) });
+    };
+
+    std::vector<BenchResult> results;
+    const float dt = 1.0f/60.0f;
+    for(const BenchPath& path : paths){
+        BenchResult r; r.name = path.name;
+        int ran = 0, measured = 0;
+        for(int f=0; f<nFrames && !glfwWindowShouldClose(win); ++f, ++ran){
+            auto t0 = std::chrono::steady_clock::now();
+            glfwPollEvents();
+            if(path.cpuAnim)
+                jobs.parallelFor(0,nSprites,ACTOR_GRAIN,[&](int i0,int i1){
+                    for(int i=i0;i<i1;++i) actors[i].Update(dt);
+                });
+            frame.upload(glfwGetTime(),dt);
+
+            glClearColor(0,0,0,1);
+            glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
+            glBeginQuery(GL_SAMPLES_PASSED,qSamples[f&1]);
+            glBeginQuery(GL_TIME_ELAPSED,qTime[f&1]);
+            path.draw();
+            glEndQuery(GL_TIME_ELAPSED);
+            glEndQuery(GL_SAMPLES_PASSED);
+            glfwSwapBuffers(win);
+            glDeletionQueue().endFrame();
+            r.stateChanges += frameStateChanges;
+            r.draws        += frameDraws;
+            r.cpuMs += std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-t0).count();
+            if(f % MEM_SAMPLE_EVERY == 0) sampleMem(path.name,f);
+
+            if(f>0){
+                GLuint64 samples = 0, ns = 0;
+                glGetQueryObjectui64v(qSamples[(f-1)&1],GL_QUERY_RESULT,&samples);
+                glGetQueryObjectui64v(qTime[(f-1)&1],GL_QUERY_RESULT,&ns);
+                r.fragments += (double)samples;
+                r.gpuMs     += ns * 1e-6;
+                ++measured;
+            }
+        }
+        sampleMem(path.name,ran);
+        if(ran)      { r.cpuMs /= ran; r.stateChanges /= ran; r.draws /= ran; }
+        if(measured){ r.gpuMs /= measured; r.fragments /= measured; }
+        results.push_back(r);
+    }
+
+    double cellPixels = (double)nSprites*CELL.x*CELL.y + (double)SCR_W*SCR_H;
+    std::printf("\n[bench] %d sprites, %d frames por caminho, %ux%u\n",nSprites,nFrames,SCR_W,SCR_H);
+    std::printf("[bench] célula inteira (referência): %.2f Mfrag/frame, overdraw %.2fx\n",
+                cellPixels*1e-6, cellPixels/(SCR_W*SCR_H));
+    std::printf("[bench] %-22s %9s %9s %12s %9s %10s %9s\n","caminho","cpu ms","gpu ms","Mfrag/frame","overdraw","estado/fr","draws/fr");
+    for(const BenchResult& r : results)
+        std::printf("[bench] %-22s %9.3f %9.3f %12.3f %8.2fx %10.0f %9.0f\n",
+                    r.name, r.cpuMs, r.gpuMs, r.fragments*1e-6, r.fragments/(SCR_W*SCR_H), r.stateChanges, r.draws);
+    for(int i=0;i<3;++i) batches[i].stream.print("lote");
+    debug.stream.print("contornos");
+    multi.stream.print("multi");
+    attribInst.stream.print("atributos");
+    pullInst.stream.print("texel");
+    pointInst.stream.print("pontos");
+    recordInst.stream.print("gravação");
+    if(animFrames)
+        std::printf("[anim] %d clipes, %.1f registros reenviados/frame (de %d)\n",
+                    clips.clips, animUploads/animFrames, nSprites);
+
+    std::printf("\n[mem] %-22s %6s %10s %10s %9s %9s %5s %5s %5s %5s\n","caminho","frame",
+                "heap KB","alocações","buf KB","tex KB","bufs","texs","vaos","progs");
+    for(const MemSample& m : memSamples)
+        std::printf("[mem] %-22s %6d %10.1f %10ld %9.1f %9.1f %5ld %5ld %5ld %5ld\n",
+                    m.path, m.frame, m.heap.bytes/1024.0, m.heap.allocs,
+                    m.buffers.bytes/1024.0, m.textures.bytes/1024.0,
+                    m.buffers.live, m.textures.live, m.vaos.live, m.programs.live);
+    printHeapReport();
+    printGpuReport();
+    glDeletionQueue().print();
+
+    // escala: o trabalho de CPU de um frame com nScale atores, de 1 a N
+    currentMemTag = MemTag::Jobs;
+    // threads; por pedaço de ACTOR_GRAIN atores, a animação e depois (após
+    // o contador do pedaço) o culling contra a janela e a montagem das
+    // instâncias visíveis no trecho do pedaço
+    std::vector<Actor> scaleActors(nScale);
+    for(int i=0;i<nScale;++i){
+        scaleActors[i].pos   = { ux(rng), uy(rng) };
+        scaleActors[i].vel   = { uv(rng), uv(rng) };
+        scaleActors[i].sheet = (i&1) ? &run : &walk;
+        scaleActors[i].frame = i % 10;
+    }
+    const int nChunks = (nScale + ACTOR_GRAIN - 1) / ACTOR_GRAIN;
+    std::vector<SpriteInstance> scaleInst(nScale);
+    std::vector<int> chunkVisible(nChunks);
+    std::unique_ptr<JobCounter[]> animated(new JobCounter[nChunks]);
+    auto scaleFrame = [&](JobSystem& js){
+        JobCounter built;
+        for(int c=0;c<nChunks;++c){
+            int i0 = c*ACTOR_GRAIN, i1 = std::min(nScale,i0+ACTOR_GRAIN);
+            js.submit([&,i0,i1]{ for(int i=i0;i<i1;++i) scaleActors[i].Update(dt); },&animated[c]);
+            js.submit([&,c,i0,i1]{
+                int n = 0;
+                for(int i=i0;i<i1;++i){
+                    const Actor& a = scaleActors[i];
+                    if(a.pos.x<viewMin.x || a.pos.y<viewMin.y || a.pos.x>viewMax.x || a.pos.y>viewMax.y) continue;
+                    scaleInst[i0 + n++] = makeInstance(a.sheet->frame(0,a.frame),a.pos,CELL);
+                }
+                chunkVisible[c] = n;
+            },&built,&animated[c]);
+        }
+        js.wait(built);
+    };
+
+    recordJobs.reset();
+    int scaleFrames = std::max(1,nFrames);
+    double baseMs = 0;
+    std::printf("\n[jobs] %d atores, %d pedaços de %d, %d frames\n",nScale,nChunks,ACTOR_GRAIN,scaleFrames);
+    std::printf("[jobs] %7s %9s %8s %10s %9s %9s\n","threads","cpu ms","speedup","eficiência","roubos/fr","visíveis");
+    for(unsigned n=1;;n = std::min(maxThreads,n*2)){
+        JobSystem js(n);
+        scaleFrame(js);                                     // aquece as threads e o cache
+        auto t0 = std::chrono::steady_clock::now();
+        long stolen0 = js.stolen();
+        for(int f=0;f<scaleFrames;++f) scaleFrame(js);
+        double ms = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-t0).count()/scaleFrames;
+        if(n==1) baseMs = ms;
+        long visible = 0;
+        for(int v : chunkVisible) visible += v;
+        std::printf("[jobs] %7u %9.3f %7.2fx %9.0f%% %9.1f %9ld\n",n,ms,baseMs/ms,100.0*baseMs/ms/n,
+                    (double)(js.stolen()-stolen0)/scaleFrames,visible);
+        if(n==maxThreads) break;
+    }
+
+    glDeletionQueue().flush();
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,240 @@
+// StreamBuffer.h
+// Buffer para dados de vértice refeitos a cada frame, dividido em três
+// segmentos usados em rodízio: o frame N escreve no segmento N%3 enquanto
+// a GPU ainda lê os dois anteriores. Ao fechar o frame uma fence marca o
+// fim dos draws do segmento, e antes de reescrevê-lo, três frames depois,
+// a fence é consultada; só se espera se a GPU estiver mesmo atrasada.
+//   - Persistent: ARB_buffer_storage, mapeado uma vez (persistente e
+//     coerente); escrever é um memcpy;
+//   - Unsynchronized: GL 3.3, glMapBufferRange(UNSYNCHRONIZED) por escrita,
+//     a sincronização fica toda com as fences;
+//   - Orphan: sem mapear; glBufferData(nullptr) ao voltar ao primeiro
+//     segmento e glBufferSubData no resto. Também é o destino se o driver
+//     recusar o mapeamento.
+// write() devolve o deslocamento alinhado ao stride, para desenhar com
+// first = deslocamento/stride sem religar atributos. reserve() entrega o
+// trecho para ser preenchido por fora (até em outras threads: memória
+// mapeada no modo Persistent, ou uma cópia local nos outros, enviada pelo
+// commit() na thread do GL antes do draw). O buffer nunca fica mapeado
+// entre as chamadas, mas só há um trecho aberto por vez: write() e outro
+// reserve() esperam o commit(). stats conta os bytes enviados e as esperas
+// por fence.
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include "GlHandle.h"
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+enum class StreamMode { Persistent, Unsynchronized, Orphan };
+
+inline const char* streamModeName(StreamMode m){
+    return m==StreamMode::Persistent     ? "persistente"
+         : m==StreamMode::Unsynchronized ? "map sem sincronia" : "orfanização";
+}
+
+// trecho reservado: ptr vale até o commit
+struct StreamSpan {
+    unsigned char* ptr = nullptr;
+    size_t at = 0, bytes = 0;
+};
+
+struct StreamStats {
+    uint64_t bytes = 0;
+    int      frames = 0, stalls = 0, grows = 0;
+    double   stallMs = 0;
+};
+
+struct StreamBuffer {
+    static const int SEGMENTS = 3;
+
+    GLenum     target  = GL_ARRAY_BUFFER;
+    GlBuffer   buffer;
+    StreamMode mode    = StreamMode::Unsynchronized;
+    size_t     segment = 0;     // bytes por segmento
+    int        current = 0;     // segmento sendo escrito
+    size_t     used    = 0;     // bytes ocupados no segmento atual
+    int        generation = 0;  // muda quando o buffer é recriado: VAOs precisam religar
+    StreamStats stats;
+
+    // preferred = Persistent cai para Unsynchronized sem ARB_buffer_storage
+    void init(size_t segmentBytes,GLenum bufferTarget = GL_ARRAY_BUFFER,
+              StreamMode preferred = StreamMode::Persistent){
+        target  = bufferTarget;
+        segment = segmentBytes;
+        mode    = preferred;
+        if(mode==StreamMode::Persistent && !(GLAD_GL_ARB_buffer_storage && glBufferStorage))
+            mode = StreamMode::Unsynchronized;
+        allocate();
+    }
+
+    void release(){
+        for(GLsync& f : fences) if(f){ glDeleteSync(f); f = nullptr; }
+        buffer.reset();                 // pela fila; a deleção desmapeia o persistente
+        mapped = nullptr;
+    }
+
+    // copia n bytes para o segmento atual; devolve o deslocamento no buffer
+    size_t write(const void* data,size_t n,size_t align = 4){
+        assert(!reserved && "StreamBuffer::write com reserve() sem commit()");
+        size_t at = place(n,align);
+        if(mode==StreamMode::Persistent) std::memcpy(mapped+at,data,n);
+        else upload(at,n,data);
+        return at;
+    }
+
+    // n bytes no segmento atual para preencher antes do commit
+    StreamSpan reserve(size_t n,size_t align = 4){
+        assert(!reserved && "StreamBuffer::reserve com outro trecho aberto");
+        StreamSpan s;
+        s.at    = place(n,align);
+        s.bytes = n;
+        if(mode==StreamMode::Persistent) s.ptr = mapped + s.at;
+        else {
+            staging.resize(n);
+            s.ptr = staging.data();
+        }
+        reserved = true;
+        return s;
+    }
+
+    // na thread do GL, depois de preenchido e antes do draw
+    void commit(const StreamSpan& s){
+        reserved = false;
+        if(mode==StreamMode::Persistent || !s.bytes) return;
+        upload(s.at,s.bytes,s.ptr);
+    }
+
+    // depois do último draw do frame que usa o buffer
+    void endFrame(){
+        ++stats.frames;
+        if(used) nextSegment();
+    }
+
+    void print(const char* name) const {
+        double frames = stats.frames ? stats.frames : 1;
+        std::printf("[stream] %-10s %s, segmento %zu KB: %.2f MB enviados (%.1f KB/frame), "
+                    "%d esperas (%.2f ms), %d crescimentos\n",
+                    name, streamModeName(mode), segment/1024, stats.bytes/(1024.0*1024.0),
+                    stats.bytes/1024.0/frames, stats.stalls, stats.stallMs, stats.grows);
+    }
+
+private:
+    GLsync         fences[SEGMENTS] = {};
+    unsigned char* mapped = nullptr;
+    std::vector<unsigned char> staging;     // reserve() fora do modo Persistent
+    bool           reserved = false;        // trecho entregue e ainda sem commit
+
+    static size_t alignUp(size_t v,size_t a){ return (v + a-1)/a*a; }
+
+    // lugar para n bytes no segmento atual (troca de segmento ou cresce)
+    size_t place(size_t n,size_t align){
+        size_t base = current*segment;
+        size_t at = alignUp(base+used,align);
+        if(at+n > base+segment){
+            if(n+align > segment) grow(n+align);
+            else                  nextSegment();    // segmento cheio no meio do frame
+            base = current*segment;
+            at = alignUp(base,align);
+        }
+        used = at+n - base;
+        stats.bytes += n;
+        return at;
+    }
+
+    // n bytes em at, fora do modo Persistent: mapeia sem sincronia e
+    // desmapeia na hora; se o driver recusar, passa a orfanizar
+    void upload(size_t at,size_t n,const void* data){
+        glBindBuffer(target,buffer);
+        void* p = nullptr;
+        if(mode==StreamMode::Unsynchronized){
+            p = glMapBufferRange(target,at,n,
+                    GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+            if(p){ std::memcpy(p,data,n); glUnmapBuffer(target); }
+            else mode = StreamMode::Orphan;
+        }
+        if(!p) orphanUpload(at,n,data);
+    }
+
+    // buffer já ligado em target
+    void orphanUpload(size_t at,size_t n,const void* data){
+        if(at==0)               // primeiro envio do segmento 0
+            glBufferData(target,SEGMENTS*segment,nullptr,GL_STREAM_DRAW);
+        glBufferSubData(target,at,n,data);
+    }
+
+    // o buffer anterior, se houver, sai pela fila de deleção
+    void allocate(){
+        buffer = GlBuffer::create();
+        glBindBuffer(target,buffer);
+        GLsizeiptr size = (GLsizeiptr)(SEGMENTS*segment);
+        if(mode==StreamMode::Persistent){
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(target,size,nullptr,flags);
+            mapped = (unsigned char*)glMapBufferRange(target,0,size,flags);
+            if(!mapped){
+                buffer = GlBuffer::create();    // storage imutável: recria como mutável
+                glBindBuffer(target,buffer);
+                mode = StreamMode::Unsynchronized;
+            }
+        }
+        if(mode!=StreamMode::Persistent) glBufferData(target,size,nullptr,GL_STREAM_DRAW);
+        glBindBuffer(target,0);
+        current = 0;
+        used = 0;
+    }
+
+    // fecha o segmento atual com uma fence e espera o próximo ficar livre
+    void nextSegment(){
+        if(mode!=StreamMode::Orphan){
+            if(fences[current]) glDeleteSync(fences[current]);
+            fences[current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE,0);
+        }
+        current = (current+1) % SEGMENTS;
+        used = 0;
+        wait(current);
+    }
+
+    void wait(int s){
+        GLsync f = fences[s];
+        if(!f) return;
+        GLenum r = glClientWaitSync(f,0,0);
+        if(r==GL_TIMEOUT_EXPIRED){
+            auto t0 = std::chrono::steady_clock::now();
+            ++stats.stalls;
+            do r = glClientWaitSync(f,GL_SYNC_FLUSH_COMMANDS_BIT,1000000);
+            while(r==GL_TIMEOUT_EXPIRED);
+            stats.stallMs += std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-t0).count();
+        }
+        glDeleteSync(f);
+        fences[s] = nullptr;
+    }
+
+    // escrita maior que um segmento: dobra até caber. O mutável é realocado
+    // no mesmo nome (o driver orfaniza o antigo); o persistente precisa de
+    // um buffer novo, e generation avisa quem guarda o nome num VAO. Os
+    // draws do frame ainda leem o antigo: ele sai pela fila de deleção.
+    void grow(size_t n){
+        ++stats.grows;
+        while(segment < n) segment = segment ? segment*2 : n;
+        for(GLsync& f : fences) if(f){ glDeleteSync(f); f = nullptr; }
+        if(mode==StreamMode::Persistent){
+            mapped = nullptr;
+            allocate();
+            ++generation;
+        } else {
+            glBindBuffer(target,buffer);
+            glBufferData(target,SEGMENTS*segment,nullptr,GL_STREAM_DRAW);
+            glBindBuffer(target,0);
+            current = 0;
+            used = 0;
+        }
+    }
+};
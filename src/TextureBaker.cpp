@@ -0,0 +1,109 @@
+// TextureBaker.cpp
+// Ferramenta offline (só CPU, sem janela/GL): comprime uma PNG em DDS
+// BC1/BC3 com a cadeia completa de mips, opcionalmente já reduzida para a
+// resolução em que a textura aparece na tela. Depois de codificar,
+// decodifica de volta e mede o PSNR; abaixo do mínimo a ferramenta falha,
+// o que quebra o build se o codificador regredir.
+//
+// uso: TextureBaker <entrada.png> <saida.dds> [--fit LxA] [--format auto|bc1|bc3] [--min-psnr dB]
+//      TextureBaker --selftest
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "TextureCompress.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+// imagens sintéticas com gradiente, cor sólida e alfa recortado
+static int selfTest(){
+    int fails = 0;
+    auto check = [&](const char* name,const Image& img,BlockFormat fmt,double minPsnr){
+        std::vector<unsigned char> enc = encodeImage(img,fmt);
+        Image dec = decodeImage(enc.data(),img.w,img.h,fmt);
+        double p = psnr(img,dec);
+        bool ok = enc.size()==compressedSize(fmt,img.w,img.h) && p>=minPsnr;
+        std::printf("[selftest] %-10s %s %3dx%-3d psnr %6.2f dB  %s\n",
+                    name, blockFormatName(fmt), img.w, img.h, p, ok ? "ok" : "FALHOU");
+        fails += !ok;
+    };
+
+    Image grad(64,36);
+    for(int y=0;y<grad.h;++y) for(int x=0;x<grad.w;++x){
+        unsigned char* p = grad.row(y) + x*4;
+        p[0] = x*4; p[1] = y*7; p[2] = 255 - x*2; p[3] = 255;
+    }
+    check("gradiente", grad, BlockFormat::BC1, 32.0);
+
+    Image solid(13,7);
+    for(size_t i=0;i<solid.px.size();i+=4){
+        solid.px[i]=200; solid.px[i+1]=40; solid.px[i+2]=90; solid.px[i+3]=255;
+    }
+    check("solido", solid, BlockFormat::BC1, 40.0);
+
+    Image cut = grad;
+    for(int y=0;y<cut.h;++y) for(int x=0;x<cut.w;++x)
+        cut.row(y)[x*4+3] = ((x-32)*(x-32) + (y-18)*(y-18) < 200) ? 255 : (x%5==0 ? 128 : 0);
+    check("recorte", cut, BlockFormat::BC3, 30.0);
+
+    // DDS de ida e volta
+    CompressedTexture ct = compressWithMips(grad,BlockFormat::BC1), rd;
+    bool ok = writeDDS("selftest.dds",ct) && readDDS("selftest.dds",rd)
+           && rd.w==ct.w && rd.h==ct.h && rd.levels==ct.levels;
+    std::remove("selftest.dds");
+    std::printf("[selftest] dds        %zu níveis  %s\n", ct.levels.size(), ok ? "ok" : "FALHOU");
+    fails += !ok;
+    return fails ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int main(int argc,char** argv){
+    if(argc>=2 && std::string(argv[1])=="--selftest") return selfTest();
+    if(argc<3){
+        std::cerr<<"uso: "<<argv[0]<<" <entrada.png> <saida.dds> [--fit LxA] [--format auto|bc1|bc3] [--min-psnr dB]\n";
+        return EXIT_FAILURE;
+    }
+    const char* in  = argv[1];
+    const char* out = argv[2];
+    int fitW = 0, fitH = 0;
+    std::string format = "auto";
+    double minPsnr = 30.0;
+    for(int i=3; i+1<argc; i+=2){
+        std::string a = argv[i];
+        if     (a=="--fit")      std::sscanf(argv[i+1],"%dx%d",&fitW,&fitH);
+        else if(a=="--format")   format = argv[i+1];
+        else if(a=="--min-psnr") minPsnr = std::atof(argv[i+1]);
+        else { std::cerr<<"opção desconhecida: "<<a<<"\n"; return EXIT_FAILURE; }
+    }
+
+    // mesma orientação que as demos usam ao carregar
+    stbi_set_flip_vertically_on_load(true);
+    int w,h,n;
+    unsigned char* data = stbi_load(in,&w,&h,&n,4);
+    if(!data){ std::cerr<<"Erro ao carregar "<<in<<"\n"; return EXIT_FAILURE; }
+    Image img = Image::fromRGBA(w,h,data);
+    stbi_image_free(data);
+
+    img = fitToTarget(std::move(img),fitW,fitH);
+    BlockFormat fmt = format=="bc1" ? BlockFormat::BC1
+                    : format=="bc3" ? BlockFormat::BC3
+                    : (hasAlpha(img) ? BlockFormat::BC3 : BlockFormat::BC1);
+
+    auto t0 = std::chrono::steady_clock::now();
+    CompressedTexture ct = compressWithMips(img,fmt);
+    double ms = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-t0).count();
+
+    Image dec = decodeImage(ct.levels[0].data(),ct.w,ct.h,fmt);
+    double p = psnr(img,dec);
+    size_t raw = mipChainBytes(ct.w,ct.h);
+    std::printf("[bake] %s: %dx%d -> %dx%d %s, %.1f KB -> %.1f KB (%.1fx), psnr %.2f dB, %.1f ms\n",
+                in, w, h, ct.w, ct.h, blockFormatName(fmt),
+                raw/1024.0, ct.bytes()/1024.0, (double)raw/ct.bytes(), p, ms);
+
+    if(p < minPsnr){
+        std::cerr<<"PSNR abaixo do mínimo ("<<minPsnr<<" dB)\n";
+        return EXIT_FAILURE;
+    }
+    if(!writeDDS(out,ct)){ std::cerr<<"Erro ao escrever "<<out<<"\n"; return EXIT_FAILURE; }
+    return EXIT_SUCCESS;
+}
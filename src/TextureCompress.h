@@ -0,0 +1,362 @@
+// TextureCompress.h
+// Codificador/decodificador de blocos BC1 (DXT1) e BC3 (DXT5) em CPU e
+// leitura/escrita de DDS com a cadeia de mips. Usado offline pelo
+// TextureBaker e, em tempo de carga, para comprimir atlases gerados.
+// Não depende de GL.
+//
+// As linhas ficam na mesma orientação que o resto do pipeline (stbi com
+// flip: linha 0 = base da textura), então o DDS sobe direto no GL.
+
+#pragma once
+
+#include "Image.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+enum class BlockFormat { BC1, BC3 };
+
+inline const char* blockFormatName(BlockFormat f){ return f==BlockFormat::BC1 ? "BC1" : "BC3"; }
+inline int blockBytes(BlockFormat f){ return f==BlockFormat::BC1 ? 8 : 16; }
+
+inline size_t compressedSize(BlockFormat f,int w,int h){
+    return (size_t)((w+3)/4) * ((h+3)/4) * blockBytes(f);
+}
+
+// ——————————————————————
+// Cores 565
+
+inline uint16_t pack565(float r,float g,float b){
+    auto q = [](float v,int maxv){
+        int i = (int)std::lround(v * maxv / 255.0f);
+        return i<0 ? 0 : (i>maxv ? maxv : i);
+    };
+    return (uint16_t)((q(r,31)<<11) | (q(g,63)<<5) | q(b,31));
+}
+
+inline void unpack565(uint16_t c,int rgb[3]){
+    int r = (c>>11)&31, g = (c>>5)&63, b = c&31;
+    rgb[0] = (r<<3)|(r>>2);
+    rgb[1] = (g<<2)|(g>>4);
+    rgb[2] = (b<<3)|(b>>2);
+}
+
+// paleta do bloco: 4 cores (c0 > c1) ou 3 cores + transparente
+inline void bc1Palette(uint16_t c0,uint16_t c1,int pal[4][3],bool fourColor){
+    unpack565(c0,pal[0]);
+    unpack565(c1,pal[1]);
+    for(int k=0;k<3;++k){
+        if(fourColor){
+            pal[2][k] = (2*pal[0][k] + pal[1][k]) / 3;
+            pal[3][k] = (pal[0][k] + 2*pal[1][k]) / 3;
+        } else {
+            pal[2][k] = (pal[0][k] + pal[1][k]) / 2;
+            pal[3][k] = 0;
+        }
+    }
+}
+
+// ——————————————————————
+// Bloco de cor (BC1 e metade de cor do BC3)
+
+// escolhe índices para os endpoints dados; devolve o erro quadrático
+inline int fitColorIndices(const unsigned char blk[64],const bool use[16],
+                           uint16_t c0,uint16_t c1,uint32_t& idx){
+    int pal[4][3];
+    bc1Palette(c0,c1,pal,true);
+    idx = 0;
+    int err = 0;
+    for(int i=0;i<16;++i){
+        int best = 0, bestD = 1<<30;
+        for(int p=0;p<4;++p){
+            int dr = blk[i*4]-pal[p][0], dg = blk[i*4+1]-pal[p][1], db = blk[i*4+2]-pal[p][2];
+            int d = dr*dr + dg*dg + db*db;
+            if(d<bestD){ bestD=d; best=p; }
+        }
+        idx |= (uint32_t)best << (2*i);
+        if(use[i]) err += bestD;
+    }
+    return err;
+}
+
+inline void writeColorBlock(unsigned char out[8],uint16_t c0,uint16_t c1,uint32_t idx){
+    out[0] = c0 & 0xFF; out[1] = c0 >> 8;
+    out[2] = c1 & 0xFF; out[3] = c1 >> 8;
+    out[4] = idx & 0xFF; out[5] = (idx>>8) & 0xFF; out[6] = (idx>>16) & 0xFF; out[7] = idx >> 24;
+}
+
+// endpoints pelo eixo principal (PCA) + um refinamento por mínimos quadrados.
+// Pixels totalmente transparentes não entram no ajuste de cor.
+inline void encodeColorBlock(const unsigned char blk[64],unsigned char out[8]){
+    bool use[16]; int n = 0;
+    for(int i=0;i<16;++i){ use[i] = blk[i*4+3] > 0; n += use[i]; }
+    if(n==0){ for(int i=0;i<16;++i) use[i] = true; n = 16; }
+
+    float mean[3] = {0,0,0};
+    for(int i=0;i<16;++i) if(use[i]) for(int k=0;k<3;++k) mean[k] += blk[i*4+k];
+    for(int k=0;k<3;++k) mean[k] /= n;
+
+    float cov[6] = {0,0,0,0,0,0};   // xx xy xz yy yz zz
+    for(int i=0;i<16;++i) if(use[i]){
+        float r = blk[i*4]-mean[0], g = blk[i*4+1]-mean[1], b = blk[i*4+2]-mean[2];
+        cov[0]+=r*r; cov[1]+=r*g; cov[2]+=r*b; cov[3]+=g*g; cov[4]+=g*b; cov[5]+=b*b;
+    }
+    float axis[3] = {1,1,1};
+    for(int it=0; it<6; ++it){
+        float x = cov[0]*axis[0] + cov[1]*axis[1] + cov[2]*axis[2];
+        float y = cov[1]*axis[0] + cov[3]*axis[1] + cov[4]*axis[2];
+        float z = cov[2]*axis[0] + cov[4]*axis[1] + cov[5]*axis[2];
+        float m = std::max(std::fabs(x), std::max(std::fabs(y), std::fabs(z)));
+        if(m < 1e-6f) break;
+        axis[0] = x/m; axis[1] = y/m; axis[2] = z/m;
+    }
+
+    float tmin = 1e30f, tmax = -1e30f;
+    for(int i=0;i<16;++i) if(use[i]){
+        float t = (blk[i*4]-mean[0])*axis[0] + (blk[i*4+1]-mean[1])*axis[1] + (blk[i*4+2]-mean[2])*axis[2];
+        tmin = std::min(tmin,t); tmax = std::max(tmax,t);
+    }
+    float len2 = axis[0]*axis[0] + axis[1]*axis[1] + axis[2]*axis[2];
+    if(len2 > 0){ tmin /= len2; tmax /= len2; }
+    auto at = [&](float t,int k){ return std::min(255.0f, std::max(0.0f, mean[k] + axis[k]*t)); };
+
+    uint16_t c0 = pack565(at(tmax,0),at(tmax,1),at(tmax,2));
+    uint16_t c1 = pack565(at(tmin,0),at(tmin,1),at(tmin,2));
+    if(c0 < c1) std::swap(c0,c1);
+    if(c0 == c1){ writeColorBlock(out,c0,c1,0); return; }
+
+    uint32_t idx;
+    int err = fitColorIndices(blk,use,c0,c1,idx);
+
+    // refinamento: resolve os endpoints que minimizam o erro para esses índices
+    static const float wgt[4] = {1.0f, 0.0f, 2.0f/3.0f, 1.0f/3.0f};
+    float aa=0, ab=0, bb=0, ax[3]={0,0,0}, bx[3]={0,0,0};
+    for(int i=0;i<16;++i) if(use[i]){
+        float a = wgt[(idx>>(2*i))&3], b = 1.0f - a;
+        aa += a*a; ab += a*b; bb += b*b;
+        for(int k=0;k<3;++k){ ax[k] += a*blk[i*4+k]; bx[k] += b*blk[i*4+k]; }
+    }
+    float det = aa*bb - ab*ab;
+    if(std::fabs(det) > 1e-6f){
+        float e0[3], e1[3];
+        for(int k=0;k<3;++k){
+            e0[k] = std::min(255.0f, std::max(0.0f, (ax[k]*bb - bx[k]*ab) / det));
+            e1[k] = std::min(255.0f, std::max(0.0f, (bx[k]*aa - ax[k]*ab) / det));
+        }
+        uint16_t r0 = pack565(e0[0],e0[1],e0[2]);
+        uint16_t r1 = pack565(e1[0],e1[1],e1[2]);
+        if(r0 < r1) std::swap(r0,r1);
+        if(r0 != r1){
+            uint32_t ridx;
+            int rerr = fitColorIndices(blk,use,r0,r1,ridx);
+            if(rerr < err){ c0 = r0; c1 = r1; idx = ridx; }
+        }
+    }
+    writeColorBlock(out,c0,c1,idx);
+}
+
+// ——————————————————————
+// Bloco de alfa (BC3)
+
+inline void alphaPalette(int a0,int a1,int pal[8]){
+    pal[0] = a0; pal[1] = a1;
+    if(a0 > a1){
+        for(int i=1;i<7;++i) pal[i+1] = ((7-i)*a0 + i*a1) / 7;
+    } else {
+        for(int i=1;i<5;++i) pal[i+1] = ((5-i)*a0 + i*a1) / 5;
+        pal[6] = 0; pal[7] = 255;
+    }
+}
+
+inline int fitAlphaIndices(const unsigned char blk[64],int a0,int a1,uint64_t& bits){
+    int pal[8];
+    alphaPalette(a0,a1,pal);
+    bits = 0;
+    int err = 0;
+    for(int i=0;i<16;++i){
+        int a = blk[i*4+3], best = 0, bestD = 1<<30;
+        for(int p=0;p<8;++p){
+            int d = (a-pal[p])*(a-pal[p]);
+            if(d<bestD){ bestD=d; best=p; }
+        }
+        bits |= (uint64_t)best << (3*i);
+        err += bestD;
+    }
+    return err;
+}
+
+// tenta os dois modos (8 valores interpolados, ou 6 + 0/255) e fica com o melhor
+inline void encodeAlphaBlock(const unsigned char blk[64],unsigned char out[8]){
+    int lo = 255, hi = 0, ilo = 255, ihi = 0;
+    for(int i=0;i<16;++i){
+        int a = blk[i*4+3];
+        lo = std::min(lo,a); hi = std::max(hi,a);
+        if(a!=0 && a!=255){ ilo = std::min(ilo,a); ihi = std::max(ihi,a); }
+    }
+    uint64_t bits8, bits6;
+    int a0 = hi, a1 = lo;
+    int err8 = fitAlphaIndices(blk,a0,a1,bits8);
+    int b0 = ilo>ihi ? 0 : ilo, b1 = ilo>ihi ? 255 : ihi;
+    int err6 = fitAlphaIndices(blk,b0,b1,bits6);
+
+    uint64_t bits = bits8;
+    if(err6 < err8){ a0 = b0; a1 = b1; bits = bits6; }
+    out[0] = (unsigned char)a0;
+    out[1] = (unsigned char)a1;
+    for(int k=0;k<6;++k) out[2+k] = (unsigned char)(bits >> (8*k));
+}
+
+// ——————————————————————
+// Imagem inteira
+
+// copia o bloco 4x4 em (bx,by), repetindo a borda quando a imagem não é múltipla de 4
+inline void gatherBlock(const Image& img,int bx,int by,unsigned char blk[64]){
+    for(int y=0;y<4;++y){
+        const unsigned char* r = img.row(std::min(by*4+y, img.h-1));
+        for(int x=0;x<4;++x)
+            std::memcpy(blk + (y*4+x)*4, r + std::min(bx*4+x, img.w-1)*4, 4);
+    }
+}
+
+inline std::vector<unsigned char> encodeImage(const Image& img,BlockFormat fmt){
+    int bw = (img.w+3)/4, bh = (img.h+3)/4, bs = blockBytes(fmt);
+    std::vector<unsigned char> out((size_t)bw*bh*bs);
+    auto work = [&](int y0,int y1){
+        unsigned char blk[64];
+        for(int by=y0; by<y1; ++by)
+            for(int bx=0; bx<bw; ++bx){
+                unsigned char* dst = out.data() + ((size_t)by*bw + bx)*bs;
+                gatherBlock(img,bx,by,blk);
+                if(fmt==BlockFormat::BC3){ encodeAlphaBlock(blk,dst); dst += 8; }
+                encodeColorBlock(blk,dst);
+            }
+    };
+    jobSystem().parallelFor(0,bh,8,work);      // 8 linhas de blocos por tarefa
+    return out;
+}
+
+inline Image decodeImage(const unsigned char* data,int w,int h,BlockFormat fmt){
+    Image img(w,h);
+    int bw = (w+3)/4, bh = (h+3)/4, bs = blockBytes(fmt);
+    for(int by=0; by<bh; ++by)
+        for(int bx=0; bx<bw; ++bx){
+            const unsigned char* src = data + ((size_t)by*bw + bx)*bs;
+            int apal[8]; uint64_t abits = 0;
+            if(fmt==BlockFormat::BC3){
+                alphaPalette(src[0],src[1],apal);
+                for(int k=0;k<6;++k) abits |= (uint64_t)src[2+k] << (8*k);
+                src += 8;
+            }
+            uint16_t c0 = src[0] | (src[1]<<8), c1 = src[2] | (src[3]<<8);
+            uint32_t idx = src[4] | (src[5]<<8) | (src[6]<<16) | ((uint32_t)src[7]<<24);
+            bool four = fmt==BlockFormat::BC3 || c0 > c1;
+            int pal[4][3];
+            bc1Palette(c0,c1,pal,four);
+            for(int i=0;i<16;++i){
+                int x = bx*4 + (i&3), y = by*4 + (i>>2);
+                if(x>=w || y>=h) continue;
+                int p = (idx >> (2*i)) & 3;
+                unsigned char* d = img.row(y) + x*4;
+                d[0] = pal[p][0]; d[1] = pal[p][1]; d[2] = pal[p][2];
+                if(fmt==BlockFormat::BC3) d[3] = apal[(abits >> (3*i)) & 7];
+                else                      d[3] = (!four && p==3) ? 0 : 255;
+            }
+        }
+    return img;
+}
+
+inline bool hasAlpha(const Image& img){
+    for(size_t i=3; i<img.px.size(); i+=4) if(img.px[i] != 255) return true;
+    return false;
+}
+
+// PSNR em dB sobre RGB pré-multiplicado + alfa: a cor de texels
+// transparentes não aparece na tela, então não conta como erro
+inline double psnr(const Image& a,const Image& b){
+    double se = 0;
+    for(size_t i=0;i<a.px.size();i+=4){
+        for(int k=0;k<3;++k){
+            double d = (a.px[i+k]*a.px[i+3] - b.px[i+k]*b.px[i+3]) / 255.0;
+            se += d*d;
+        }
+        double d = (double)a.px[i+3] - b.px[i+3];
+        se += d*d;
+    }
+    if(se == 0) return 99.0;
+    return 10.0 * std::log10(255.0*255.0 / (se / a.px.size()));
+}
+
+// ——————————————————————
+// DDS (só o subconjunto DXT1/DXT5 com mips)
+
+struct CompressedTexture {
+    BlockFormat fmt = BlockFormat::BC1;
+    int w = 0, h = 0;
+    std::vector<std::vector<unsigned char>> levels;   // nível 0 primeiro
+
+    size_t bytes() const { size_t s = 0; for(auto& l : levels) s += l.size(); return s; }
+};
+
+// comprime a imagem e toda a sua cadeia de mips
+inline CompressedTexture compressWithMips(Image img,BlockFormat fmt){
+    CompressedTexture ct;
+    ct.fmt = fmt; ct.w = img.w; ct.h = img.h;
+    for(;;){
+        ct.levels.push_back(encodeImage(img,fmt));
+        if(img.w==1 && img.h==1) break;
+        img = downsample2x(img);
+    }
+    return ct;
+}
+
+inline bool writeDDS(const std::string& path,const CompressedTexture& ct){
+    uint32_t hdr[31] = {0};
+    hdr[0]  = 124;                                     // dwSize
+    hdr[1]  = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000;
+    hdr[2]  = ct.h;
+    hdr[3]  = ct.w;
+    hdr[4]  = (uint32_t)ct.levels[0].size();           // linear size
+    hdr[6]  = (uint32_t)ct.levels.size();              // mip count
+    hdr[18] = 32;                                      // ddspf.dwSize
+    hdr[19] = 0x4;                                     // DDPF_FOURCC
+    std::memcpy(&hdr[20], ct.fmt==BlockFormat::BC1 ? "DXT1" : "DXT5", 4);
+    hdr[26] = 0x1000 | 0x400000 | 0x8;                 // TEXTURE | MIPMAP | COMPLEX
+
+    FILE* f = std::fopen(path.c_str(),"wb");
+    if(!f) return false;
+    bool ok = std::fwrite("DDS ",1,4,f)==4 && std::fwrite(hdr,4,31,f)==31;
+    for(auto& l : ct.levels) ok = ok && std::fwrite(l.data(),1,l.size(),f)==l.size();
+    std::fclose(f);
+    return ok;
+}
+
+inline bool readDDS(const std::string& path,CompressedTexture& ct){
+    FILE* f = std::fopen(path.c_str(),"rb");
+    if(!f) return false;
+    char magic[4]; uint32_t hdr[31];
+    bool ok = std::fread(magic,1,4,f)==4 && std::memcmp(magic,"DDS ",4)==0
+           && std::fread(hdr,4,31,f)==31 && hdr[0]==124 && (hdr[19] & 0x4);
+    if(ok){
+        if     (std::memcmp(&hdr[20],"DXT1",4)==0) ct.fmt = BlockFormat::BC1;
+        else if(std::memcmp(&hdr[20],"DXT5",4)==0) ct.fmt = BlockFormat::BC3;
+        else ok = false;
+    }
+    if(ok){
+        ct.h = (int)hdr[2]; ct.w = (int)hdr[3];
+        int count = std::max(1u, hdr[6]);
+        int w = ct.w, h = ct.h;
+        ct.levels.clear();
+        for(int i=0; i<count && ok; ++i){
+            std::vector<unsigned char> l(compressedSize(ct.fmt,w,h));
+            ok = std::fread(l.data(),1,l.size(),f)==l.size();
+            ct.levels.push_back(std::move(l));
+            w = std::max(1,w/2); h = std::max(1,h/2);
+        }
+    }
+    std::fclose(f);
+    return ok;
+}
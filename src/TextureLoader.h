@@ -0,0 +1,169 @@
+// TextureLoader.h
+// Política de carga sensível à resolução: dada a imagem de origem e o
+// tamanho em que ela vai aparecer na tela, gera a menor variante (metades
+// sucessivas, ver Image.h) que ainda cobre esse tamanho e só então sobe
+// para a GPU, registrando a memória economizada por textura.
+// Quando existe um DDS pré-processado pelo TextureBaker e o driver expõe
+// S3TC, ele é usado no lugar da PNG (BC1/BC3, 4-8x menos VRAM).
+// As texturas voltam como GlTexture (GlHandle.h): quem guarda é o dono.
+// Header-only; a decodificação (stb_image) continua no .cpp de cada demo.
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include "GlHandle.h"
+#include "Image.h"
+#include "TextureCompress.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+// ——————————————————————
+// Estatísticas por textura
+
+struct TextureStats {
+    std::string path;
+    const char* format = "RGBA8";
+    int    srcW = 0, srcH = 0;
+    int    w = 0, h = 0;
+    size_t srcBytes = 0;     // VRAM que a fonte ocuparia (com mips)
+    size_t bytes    = 0;     // VRAM efetivamente usada (com mips)
+    double resizeMs = 0, uploadMs = 0;
+
+    size_t saved() const { return srcBytes > bytes ? srcBytes - bytes : 0; }
+};
+
+inline std::vector<TextureStats>& textureStats(){
+    static std::vector<TextureStats> stats;
+    return stats;
+}
+
+inline void printTextureStats(){
+    size_t src = 0, used = 0;
+    for(const auto& s : textureStats()){
+        std::printf("[tex] %-36s %5dx%-5d -> %5dx%-5d %-5s  %7.2f MB -> %7.2f MB  (resize %.2f ms, upload %.2f ms)\n",
+                    s.path.c_str(), s.srcW, s.srcH, s.w, s.h, s.format,
+                    s.srcBytes/1048576.0, s.bytes/1048576.0, s.resizeMs, s.uploadMs);
+        src += s.srcBytes; used += s.bytes;
+    }
+    std::printf("[tex] total %.2f MB -> %.2f MB (economia de %.2f MB)\n",
+                src/1048576.0, used/1048576.0, (src-used)/1048576.0);
+}
+
+// ——————————————————————
+// Upload
+
+// sobe RGBA8 com mipmaps; mesmos parâmetros de amostragem das demos
+inline GlTexture uploadTexture(const Image& img){
+    GlTexture t = GlTexture::create();
+    glBindTexture(GL_TEXTURE_2D,t);
+      glPixelStorei(GL_UNPACK_ALIGNMENT,1);
+      glTexImage2D(GL_TEXTURE_2D,0,GL_RGBA,img.w,img.h,0,GL_RGBA,GL_UNSIGNED_BYTE,img.px.data());
+      glGenerateMipmap(GL_TEXTURE_2D);
+      glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR_MIPMAP_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D,0);
+    return t;
+}
+
+// aplica a política de resolução, sobe e registra quanto foi economizado
+inline GlTexture uploadTextureFit(const char* path,Image img,int targetW,int targetH){
+    using clk = std::chrono::steady_clock;
+    TextureStats s;
+    s.path = path;
+    s.srcW = img.w; s.srcH = img.h;
+    s.srcBytes = mipChainBytes(img.w,img.h);
+
+    auto t0 = clk::now();
+    img = fitToTarget(std::move(img),targetW,targetH);
+    auto t1 = clk::now();
+    GlTexture tex = uploadTexture(img);
+    auto t2 = clk::now();
+
+    s.w = img.w; s.h = img.h;
+    s.bytes    = mipChainBytes(img.w,img.h);
+    s.resizeMs = std::chrono::duration<double,std::milli>(t1-t0).count();
+    s.uploadMs = std::chrono::duration<double,std::milli>(t2-t1).count();
+    textureStats().push_back(s);
+    return tex;
+}
+
+// ——————————————————————
+// Texturas comprimidas (DDS gerado pelo TextureBaker)
+
+inline bool compressedTexturesSupported(){
+    return GLAD_GL_EXT_texture_compression_s3tc != 0;
+}
+
+inline GLenum glFormatFor(BlockFormat f){
+    return f==BlockFormat::BC1 ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+                               : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+}
+
+// "resources/x.png" -> "resources/x.dds"
+inline std::string bakedPathFor(const char* path){
+    std::string p = path;
+    size_t dot = p.find_last_of('.');
+    return (dot==std::string::npos ? p : p.substr(0,dot)) + ".dds";
+}
+
+// sobe a cadeia de mips a partir de firstLevel
+inline GlTexture uploadCompressed(const CompressedTexture& ct,int firstLevel){
+    GLenum fmt = glFormatFor(ct.fmt);
+    int w = std::max(1, ct.w >> firstLevel), h = std::max(1, ct.h >> firstLevel);
+    int n = (int)ct.levels.size() - firstLevel;
+    GlTexture t = GlTexture::create();
+    glBindTexture(GL_TEXTURE_2D,t);
+      for(int i=0; i<n; ++i){
+          const auto& l = ct.levels[firstLevel+i];
+          glCompressedTexImage2D(GL_TEXTURE_2D,i,fmt,w,h,0,(GLsizei)l.size(),l.data());
+          w = std::max(1,w/2); h = std::max(1,h/2);
+      }
+      glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAX_LEVEL,n-1);
+      glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR_MIPMAP_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D,0);
+    return t;
+}
+
+// tenta o DDS pré-processado; devolve um handle vazio (e a demo cai na PNG) se não há
+// arquivo, se falta a extensão S3TC ou se o DDS não cobre o alvo.
+// Níveis maiores que o necessário são descartados, como em fitToTarget.
+inline GlTexture loadBakedTexture(const char* path,int targetW,int targetH){
+    if(!compressedTexturesSupported()) return GlTexture();
+    using clk = std::chrono::steady_clock;
+    auto t0 = clk::now();
+    CompressedTexture ct;
+    if(!readDDS(bakedPathFor(path),ct)) return GlTexture();
+
+    auto covers = [&](int w,int h){
+        return (targetW<=0 || w>=targetW) && (targetH<=0 || h>=targetH);
+    };
+    if(!covers(ct.w,ct.h)) return GlTexture();
+    int first = 0;
+    while(first+1 < (int)ct.levels.size()
+          && covers(std::max(1,ct.w>>(first+1)), std::max(1,ct.h>>(first+1))))
+        ++first;
+
+    auto t1 = clk::now();
+    GlTexture tex = uploadCompressed(ct,first);
+    auto t2 = clk::now();
+
+    TextureStats s;
+    s.path   = bakedPathFor(path);
+    s.format = blockFormatName(ct.fmt);
+    s.srcW = ct.w; s.srcH = ct.h;
+    s.w = std::max(1,ct.w>>first); s.h = std::max(1,ct.h>>first);
+    s.srcBytes = mipChainBytes(ct.w,ct.h);
+    for(size_t i=first; i<ct.levels.size(); ++i) s.bytes += ct.levels[i].size();
+    s.resizeMs = std::chrono::duration<double,std::milli>(t1-t0).count();
+    s.uploadMs = std::chrono::duration<double,std::milli>(t2-t1).count();
+    textureStats().push_back(s);
+    return tex;
+}
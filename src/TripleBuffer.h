@@ -0,0 +1,47 @@
+// TripleBuffer.h
+// Troca sem trava entre um produtor e um consumidor. São três cópias de T:
+// uma é do escritor, outra do leitor, e a do meio passa de um para o outro
+// num único exchange atômico. O escritor preenche back() e publica, e o
+// leitor pega a mais nova com fetch() e lê front() à vontade. Ninguém
+// espera ninguém: se o escritor publica duas vezes antes de o leitor
+// buscar, a mais antiga é descartada (dropped), e se o leitor busca sem
+// nada novo, continua com a que já tem.
+// back() pode voltar com o conteúdo de duas publicações atrás, então o
+// escritor precisa reescrever tudo (clear + push_back reaproveita a
+// capacidade dos vectors).
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+template<class T>
+struct TripleBuffer {
+    long published = 0, dropped = 0;        // só o escritor mexe
+    long fetched = 0;                       // só o leitor mexe
+
+    // escritor
+    T& back(){ return slots[writeIdx]; }
+    void publish(){
+        uint8_t old = middle.exchange(writeIdx | FRESH,std::memory_order_acq_rel);
+        if(old & FRESH) ++dropped;
+        writeIdx = old & INDEX;
+        ++published;
+    }
+
+    // leitor: true se trocou para uma publicação nova
+    bool fetch(){
+        if(!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        uint8_t old = middle.exchange(readIdx,std::memory_order_acq_rel);
+        readIdx = old & INDEX;
+        ++fetched;
+        return true;
+    }
+    const T& front() const { return slots[readIdx]; }
+
+private:
+    static constexpr uint8_t INDEX = 3, FRESH = 4;
+    T slots[3];
+    std::atomic<uint8_t> middle{1};         // índice da cópia do meio | FRESH se ainda não lida
+    uint8_t writeIdx = 0, readIdx = 2;
+};
@@ -0,0 +1,90 @@
+// YSortLayer.h
+// Camada com ordem do pintor por Y para cenas vistas de cima: quem está
+// mais alto na tela (y maior) fica mais ao fundo e é desenhado antes.
+// Entre um frame e outro a ordem quase não muda, então a reordenação é
+// incremental: sprites novos são ordenados à parte e intercalados (merge),
+// e a lista existente passa por um insertion sort, O(n + inversões).
+// Se o número de trocas estourar o orçamento (muita coisa mudou de lugar),
+// cai para o radix sort da fila de desenho. Cada frame informa quantas
+// posições mudaram e se houve ordenação completa.
+
+#pragma once
+
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// float -> uint32 que preserva a ordem (inclusive negativos)
+inline uint32_t orderedFloatBits(float f){
+    uint32_t u;
+    std::memcpy(&u,&f,sizeof u);
+    return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+}
+
+struct YSortStats {
+    int  moves = 0;         // deslocamentos feitos pelo insertion sort / merge
+    int  reordered = 0;     // posições da ordem que mudaram de dono
+    bool fullSort = false;  // caiu no radix sort
+};
+
+struct YSortLayer {
+    std::vector<int> order;         // índices dos sprites, do fundo para a frente
+    std::vector<int> pending;       // adicionados desde o último update
+    YSortStats       stats;
+    float            budget = 4.0f; // trocas por elemento antes de desistir do incremental
+
+    void add(int index){ pending.push_back(index); }
+    void clear(){ order.clear(); pending.clear(); }
+    size_t size() const { return order.size() + pending.size(); }
+
+    // y[i] = posição atual do sprite i
+    void update(const float* y){
+        stats = YSortStats();
+        auto behind = [&](int a,int b){ return y[a] > y[b]; };   // a é desenhado antes de b
+        prev.assign(order.begin(),order.end());
+
+        // recém-chegados: ordena à parte e intercala
+        if(!pending.empty()){
+            std::stable_sort(pending.begin(),pending.end(),behind);
+            size_t mid = order.size();
+            order.insert(order.end(),pending.begin(),pending.end());
+            std::inplace_merge(order.begin(),order.begin()+mid,order.end(),behind);
+            stats.moves += (int)pending.size();
+            pending.clear();
+        }
+
+        // insertion sort com orçamento
+        long limit = (long)(budget * order.size()) + 16, moves = 0;
+        bool gaveUp = false;
+        for(size_t i=1; i<order.size() && !gaveUp; ++i){
+            int v = order[i];
+            size_t j = i;
+            while(j>0 && behind(v,order[j-1])){
+                order[j] = order[j-1]; --j;
+                if(++moves > limit){ gaveUp = true; break; }
+            }
+            order[j] = v;
+        }
+        stats.moves += (int)moves;
+
+        if(gaveUp){
+            items.resize(order.size());
+            for(size_t i=0;i<order.size();++i)
+                items[i] = { ~(uint64_t)orderedFloatBits(y[order[i]]) & 0xFFFFFFFFull, (uint32_t)order[i] };
+            radixSort(items,tmp);
+            for(size_t i=0;i<order.size();++i) order[i] = (int)items[i].index;
+            stats.fullSort = true;
+        }
+
+        size_t common = std::min(prev.size(),order.size());
+        for(size_t i=0;i<common;++i) stats.reordered += prev[i]!=order[i];
+        stats.reordered += (int)(order.size()-common);
+    }
+
+private:
+    std::vector<int>      prev;
+    std::vector<SortItem> items, tmp;
+};